@@ -0,0 +1,120 @@
+/**
+ * @file bench.h
+ * @brief Helpers shared by the benchmarks of the oscsynth-bench executable.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <stddef.h>
+#include <vector>
+
+/// Length of the signals of \ref alias_energy_db.
+static const size_t kFftSize = 16384;
+
+/**
+ * @brief Call f repeatedly until at least min_seconds have passed.
+ * @param f Function object, which is called without arguments.
+ * @param min_seconds Minimum measuring time in seconds.
+ * @return Return the average time per call in nanoseconds.
+ */
+template <typename F>
+double
+bench_ns_per_call(F f, double min_seconds = 0.2)
+{
+    typedef std::chrono::steady_clock clock;
+
+    // warm up caches and branch predictors
+    f();
+
+    size_t calls = 0;
+    auto start = clock::now();
+    std::chrono::duration<double> elapsed(0.0);
+    do
+    {
+        for (size_t i = 0; i < 16; i++)
+            f();
+        calls += 16;
+        elapsed = clock::now() - start;
+    } while (elapsed.count() < min_seconds);
+
+    return elapsed.count() * 1e9 / calls;
+}
+
+/**
+ * @brief Power of a signal away from the harmonics of its fundamental, relative to its total power.
+ *        The signal is windowed (4 term Blackman-Harris) and transformed, bins within 8 bins of a
+ *        harmonic below nyquist belong to the harmonic, all others count as aliasing.
+ * @param signal kFftSize samples.
+ * @param f0 Fundamental frequency in Hz.
+ * @param fs Sample rate in Hz.
+ * @return Return the alias energy in dB.
+ */
+double alias_energy_db(const std::vector<float> &signal, double f0, double fs);
+
+/**
+ * @brief Add a result to the report of \ref bench_write_json.
+ * @param group Benchmark, e.g. "sine".
+ * @param name Row of the benchmark.
+ * @param block Block size in samples.
+ * @param voices Number of voices, 1 for a single kernel.
+ * @param ns Time per output sample in nanoseconds.
+ * @return Return void.
+ */
+void bench_record(const char *group, const char *name, size_t block, size_t voices, double ns);
+
+/**
+ * @brief Write all recorded results as JSON, to compare builds or machines.
+ * @param path Path of the file.
+ * @return Return false if the file cannot be written.
+ */
+bool bench_write_json(const char *path);
+
+/**
+ * @brief Sine oscillator: libm sin() against the SineKernel of every supported instruction set.
+ * @return Return void.
+ */
+void bench_sine();
+
+/**
+ * @brief Sawtooth and square: naive against PolyBLEP against wavetable, cost and alias energy.
+ * @return Return void.
+ */
+void bench_blep();
+
+/**
+ * @brief Noise: rand() against the NoiseKernel of every supported instruction set.
+ * @return Return void.
+ */
+void bench_noise();
+
+/**
+ * @brief Distortion: the former std::atan curve against the table, at every oversampling factor,
+ *        and the ADAA models against their curves sampled directly.
+ * @return Return void.
+ */
+void bench_distortion();
+
+/**
+ * @brief Oversampling: Up and Down for every factor and filter length, FirKernel per instruction set.
+ * @return Return void.
+ */
+void bench_oversampler();
+
+/**
+ * @brief Every DSP class alone: oscillators, noise, envelopes, filter, distortion and Oscicontainer.
+ * @return Return void.
+ */
+void bench_classes();
+
+/**
+ * @brief VoiceBank with 1 to 256 sounding voices, the cost per voice and the load at 48 kHz.
+ * @return Return void.
+ */
+void bench_polyphony();
+
+/**
+ * @brief SynthEngine with filter and distortion at block sizes from 16 to 2048 samples.
+ * @return Return void.
+ */
+void bench_blocksize();
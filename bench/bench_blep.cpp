@@ -0,0 +1,66 @@
+/**
+ * @file bench_blep.cpp
+ * @brief Benchmark of the naive, PolyBLEP and wavetable sawtooth and square oscillators.
+ */
+
+//  Besides the cost, the alias energy of every oscillator is measured: a high note is rendered,
+//  windowed and transformed, and the power of all bins away from the harmonics below nyquist is
+//  put in relation to the total power.
+
+#include "bench.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+#include "sawtoothwave.h"
+#include "squarewave.h"
+#include "wavetableosc.h"
+
+static const size_t kBlockSize = 256;
+static const int kFs = 48000;
+static const double kF0 = 2637.02;         // E7
+
+template <typename Osc>
+static void
+bench_osc(const char *name, Osc &osc)
+{
+    std::vector<float> signal(kFftSize);
+    osc.frequency(kF0);
+    osc.phase(0.0);
+    osc.renderBlock(signal.data(), kFftSize);
+    auto alias = alias_energy_db(signal, kF0, kFs);
+
+    std::vector<float> out(kBlockSize);
+    volatile float sink = 0.0f;
+    auto ns = bench_ns_per_call([&]() {
+        osc.renderBlock(out.data(), kBlockSize);
+        sink = out[kBlockSize - 1];
+    }) / kBlockSize;
+
+    printf("%-28s %12.3f %14.1f %14.1f\n", name, ns, 1e3 / ns, alias);
+    bench_record("blep", name, kBlockSize, 1, ns);
+}
+
+void
+bench_blep()
+{
+    printf("sawtooth and square at %.2f Hz, block size %zu\n", kF0, kBlockSize);
+    printf("%-28s %12s %14s %14s\n", "oscillator", "ns/sample", "Msamples/s", "alias dB");
+
+    Sawtoothwave saw(kF0, 1.0, 0, kFs);
+    bench_osc("Sawtoothwave naive", saw);
+    saw.polyblep(true);
+    bench_osc("Sawtoothwave polyblep", saw);
+    WavetableOsc wt_saw(&Wavetable::GetShape(SHAPE_SAW), kF0, 1.0, 0, kFs);
+    bench_osc("WavetableOsc saw", wt_saw);
+
+    Squarewave square(kF0, 1.0, 0, kFs);
+    bench_osc("Squarewave naive", square);
+    square.polyblep(true);
+    bench_osc("Squarewave polyblep", square);
+    WavetableOsc wt_square(&Wavetable::GetShape(SHAPE_SQUARE), kF0, 1.0, 0, kFs);
+    bench_osc("WavetableOsc square", wt_square);
+
+    printf("\n");
+}
@@ -0,0 +1,105 @@
+/**
+ * @file bench_distortion.cpp
+ * @brief Benchmark of the distortion curve and its oversampling.
+ */
+
+//  A loud, high sine is distorted; the curve adds harmonics far above nyquist, which fold back
+//  between the harmonics below it. Their energy is measured as in the oscillator benchmark.
+//  The ADAA models run at the base rate and are compared with their curves sampled directly.
+
+#include "bench.h"
+
+#include <math.h>
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+
+#include "distortion.h"
+
+static const size_t kBlockSize = 256;
+static const int kFs = 48000;
+static const double kF0 = 2637.02;         // E7
+static const double kAmplitude = 3.0;
+
+// cost and alias energy of one way to distort a block
+template <typename F>
+static void
+bench_curve(const char *name, F process)
+{
+    std::vector<float> signal(kFftSize);
+    for (size_t i = 0; i < kFftSize; i++)
+        signal[i] = (float)(kAmplitude * sin(2.0 * M_PI * kF0 * i / kFs));
+
+    std::vector<float> out(kBlockSize);
+    volatile float sink = 0.0f;
+    auto ns = bench_ns_per_call([&]() {
+        for (size_t i = 0; i < kBlockSize; i++)
+            out[i] = signal[i];
+        process(out.data(), kBlockSize);
+        sink = out[kBlockSize - 1];
+    }) / kBlockSize;
+
+    // the whole signal in blocks, after the benchmark has run through the filters
+    for (size_t done = 0; done < kFftSize; done += kBlockSize)
+        process(signal.data() + done, kBlockSize);
+    auto alias = alias_energy_db(signal, kF0, kFs);
+
+    printf("%-28s %12.3f %14.1f %14.1f\n", name, ns, 1e3 / ns, alias);
+    bench_record("distortion", name, kBlockSize, 1, ns);
+}
+
+void
+bench_distortion()
+{
+    printf("distortion of a sine at %.2f Hz, amplitude %.1f, block size %zu\n", kF0, kAmplitude, kBlockSize);
+    printf("%-28s %12s %14s %14s\n", "curve", "ns/sample", "Msamples/s", "alias dB");
+
+    Distortion distortion;
+    bench_curve("std::atan", [&](float *io, size_t n) { distortion.ProcessBlockAtan(io, n); });
+
+    for (size_t factor = 1; factor <= Oversampler::kMaxFactor; factor *= 2)
+    {
+        distortion.SetOversampling(factor);
+        char name[64];
+        snprintf(name, sizeof(name), "table, %zux oversampling", factor);
+        bench_curve(name, [&](float *io, size_t n) { distortion.ProcessBlock(io, n); });
+    }
+    distortion.SetOversampling(1);
+
+    // the other curves, sampled directly as the reference of their ADAA versions, with the
+    // blend of the Distortion (0.8)
+    const float wet = 0.8f;
+    const float dry = 1.0f / 0.8f;
+    auto clip = [](float x) { return std::min(1.0f, std::max(-1.0f, x)); };
+    auto fold = [](float x) {
+        auto p = x + 1.0f - 4.0f * floorf(0.25f * (x + 1.0f));
+        return (p < 2.0f) ? p - 1.0f : 3.0f - p;
+    };
+    bench_curve("tanh", [&](float *io, size_t n) {
+        for (size_t i = 0; i < n; i++)
+            io[i] = wet * tanhf(io[i]) + dry * io[i];
+    });
+    bench_curve("hard clip", [&](float *io, size_t n) {
+        for (size_t i = 0; i < n; i++)
+            io[i] = wet * clip(io[i]) + dry * io[i];
+    });
+    bench_curve("wavefolder", [&](float *io, size_t n) {
+        for (size_t i = 0; i < n; i++)
+            io[i] = wet * fold(io[i]) + dry * io[i];
+    });
+
+    static const struct { int model; const char *name; } kAdaa[] = {
+        {DISTORTION_ATAN_ADAA1, "atan, ADAA1"},
+        {DISTORTION_ATAN_ADAA2, "atan, ADAA2"},
+        {DISTORTION_TANH, "tanh, ADAA1"},
+        {DISTORTION_HARDCLIP, "hard clip, ADAA1"},
+        {DISTORTION_WAVEFOLDER, "wavefolder, ADAA1"},
+    };
+    for (auto &adaa : kAdaa)
+    {
+        distortion.SetModel(adaa.model);
+        bench_curve(adaa.name, [&](float *io, size_t n) { distortion.ProcessBlock(io, n); });
+    }
+
+    printf("\n");
+}
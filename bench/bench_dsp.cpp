@@ -0,0 +1,205 @@
+/**
+ * @file bench_dsp.cpp
+ * @brief Benchmark of every DSP class and of the whole voice path.
+ */
+
+//  Three views of the cost of the synthesizer: every class alone at one block size, the voice
+//  bank with a growing number of sounding voices, which shows how the load scales with the
+//  polyphony, and the complete engine with filter and distortion at growing block sizes, which
+//  shows the overhead per block. All voices are held (no envelope reaches its end), so the
+//  numbers are those of a steady chord.
+
+#include "bench.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+#include "Biquad.h"
+#include "adsr.h"
+#include "distortion.h"
+#include "noise.h"
+#include "oscicontainer.h"
+#include "releaseNote.h"
+#include "sawtoothwave.h"
+#include "sinusoid.h"
+#include "squarewave.h"
+#include "synthengine.h"
+#include "voicebank.h"
+
+static const size_t kBlockSize = 256;
+static const uint32_t kFs = 48000;
+static const double kF0 = 440.0;
+static const size_t kEngineVoices = 16;
+static const size_t kMinBlock = 16;
+static const size_t kMaxBlock = 2048;
+
+// prints and records one row of the class table
+static void
+class_row(const char *name, double ns)
+{
+    printf("%-28s %12.3f %14.1f\n", name, ns, 1e3 / ns);
+    bench_record("classes", name, kBlockSize, 1, ns);
+}
+
+// cost per sample of a generator, which writes a block
+template <typename F>
+static double
+bench_generator(F render)
+{
+    std::vector<float> out(kBlockSize);
+    volatile float sink = 0.0f;
+    return bench_ns_per_call([&]() {
+        render(out.data(), kBlockSize);
+        sink = out[kBlockSize - 1];
+    }) / kBlockSize;
+}
+
+// cost per sample of a processor, which works in place on a block of a sine, with the copy
+template <typename F>
+static double
+bench_processor(F process)
+{
+    std::vector<float> signal(kBlockSize), io(kBlockSize);
+    for (size_t i = 0; i < kBlockSize; i++)
+        signal[i] = (float)(0.8 * sin(2.0 * M_PI * kF0 * i / kFs));
+    volatile float sink = 0.0f;
+    return bench_ns_per_call([&]() {
+        for (size_t i = 0; i < kBlockSize; i++)
+            io[i] = signal[i];
+        process(io.data(), kBlockSize);
+        sink = io[kBlockSize - 1];
+    }) / kBlockSize;
+}
+
+void
+bench_classes()
+{
+    printf("dsp classes, block size %zu\n", kBlockSize);
+    printf("%-28s %12s %14s\n", "class", "ns/sample", "Msamples/s");
+
+    Sinusoid sine(kF0, 1.0, 0.0, kFs);
+    class_row("Sinusoid", bench_generator([&](float *out, size_t n) { sine.renderBlock(out, n); }));
+
+    Sawtoothwave saw(kF0, 1.0, 0.0, kFs);
+    class_row("Sawtoothwave", bench_generator([&](float *out, size_t n) { saw.renderBlock(out, n); }));
+    saw.polyblep(true);
+    class_row("Sawtoothwave, PolyBLEP", bench_generator([&](float *out, size_t n) { saw.renderBlock(out, n); }));
+
+    Squarewave square(kF0, 1.0, 0.0, kFs);
+    class_row("Squarewave", bench_generator([&](float *out, size_t n) { square.renderBlock(out, n); }));
+    square.polyblep(true);
+    class_row("Squarewave, PolyBLEP", bench_generator([&](float *out, size_t n) { square.renderBlock(out, n); }));
+
+    Noise noise(1.0);
+    class_row("Noise", bench_generator([&](float *out, size_t n) { noise.renderBlock(out, n); }));
+
+    // the attack is restarted with every block, the sustain is the constant fast path
+    ADSR adsr;
+    adsr.SetSampleRate(kFs);
+    class_row("ADSR, attack", bench_processor([&](float *io, size_t n) {
+        adsr.Reset();
+        adsr.SetState(ATTACK);
+        adsr.ProcessBlock(io, n);
+    }));
+    adsr.SetState(SUSTAIN);
+    class_row("ADSR, sustain", bench_processor([&](float *io, size_t n) { adsr.ProcessBlock(io, n); }));
+
+    releaseNote release;
+    release.gate(1);
+    class_row("releaseNote", bench_processor([&](float *io, size_t n) { release.processBlock(io, n); }));
+
+    Biquad filter(LOWPASS, 0.02, 0.707, 0.0);
+    class_row("Biquad", bench_processor([&](float *io, size_t n) { filter.ProcessBlock(io, n); }));
+    std::vector<float> cutoff(kBlockSize);
+    for (size_t i = 0; i < kBlockSize; i++)
+        cutoff[i] = 0.02f + 0.0001f * i;
+    class_row("Biquad, cutoff per sample", bench_processor([&](float *io, size_t n) {
+        filter.ProcessBlock(io, cutoff.data(), n);
+    }));
+
+    Distortion distortion(3.0);
+    class_row("Distortion", bench_processor([&](float *io, size_t n) { distortion.ProcessBlock(io, n); }));
+
+    // all generators of a voice and its envelope
+    Oscicontainer voice(kFs);
+    voice.frequency(kF0);
+    voice.setSineAmpl(1.0);
+    voice.setSawAmpl(1.0);
+    voice.setSquareAmpl(1.0);
+    voice.setNoiseAmpl(0.5);
+    voice.setReleaseNoteState(1);
+    class_row("Oscicontainer", bench_generator([&](float *out, size_t n) { voice.renderBlock(out, n); }));
+
+    printf("\n");
+}
+
+void
+bench_polyphony()
+{
+    printf("voice bank, all generators, block size %zu\n", kBlockSize);
+    printf("%-28s %12s %14s %14s %12s\n", "voices", "ns/sample", "Msamples/s", "ns/voice", "% at 48 kHz");
+
+    for (size_t voices = 1; voices <= SynthEngine::kMaxVoices; voices *= 2)
+    {
+        VoiceBank bank(kFs, voices);
+        bank.SetSineAmpl(1.0);
+        bank.SetSawAmpl(1.0);
+        bank.SetSquareAmpl(1.0);
+        bank.SetNoiseAmpl(0.5);
+        // a chord spread over five octaves, every voice sounds
+        for (size_t v = 0; v < voices; v++)
+            bank.NoteOn(v, 110.0 * pow(2.0, (double)(v % 60) / 12.0), 0.5);
+
+        std::vector<float> out(kBlockSize);
+        volatile float sink = 0.0f;
+        auto ns = bench_ns_per_call([&]() {
+            bank.RenderBlock(out.data(), kBlockSize);
+            sink = out[kBlockSize - 1];
+        }) / kBlockSize;
+
+        // share of a core, which renders the voices in real time
+        auto load = ns * 1e-9 * kFs * 100.0;
+        char name[64];
+        snprintf(name, sizeof(name), "%zu", voices);
+        printf("%-28s %12.3f %14.1f %14.3f %12.2f\n", name, ns, 1e3 / ns, ns / voices, load);
+        bench_record("polyphony", "VoiceBank", kBlockSize, voices, ns);
+    }
+    printf("\n");
+}
+
+void
+bench_blocksize()
+{
+    printf("synth engine, %zu voices, filter and distortion\n", kEngineVoices);
+    printf("%-28s %12s %14s %12s\n", "block size", "ns/sample", "Msamples/s", "% at 48 kHz");
+
+    SynthEngine engine(kFs, kMaxBlock, kEngineVoices);
+    engine.SetPreset(wobble);
+
+    // the distortion and the held notes are applied by the first block
+    synthCommand cmd = {CMD_PARAM, PARAM_DISTORTION_STATUS, 1.0};
+    engine.Schedule(0.0, cmd);
+    for (size_t v = 0; v < kEngineVoices; v++)
+    {
+        synthCommand note = {CMD_NOTE_ON, (int32_t)(36 + 3 * v), 0.8};
+        engine.Schedule(0.0, note);
+    }
+
+    std::vector<float> out(kMaxBlock);
+    for (size_t block = kMinBlock; block <= kMaxBlock; block *= 2)
+    {
+        volatile float sink = 0.0f;
+        auto ns = bench_ns_per_call([&]() {
+            engine.Render(out.data(), block);
+            sink = out[block - 1];
+        }) / block;
+
+        auto load = ns * 1e-9 * kFs * 100.0;
+        char name[64];
+        snprintf(name, sizeof(name), "%zu", block);
+        printf("%-28s %12.3f %14.1f %12.2f\n", name, ns, 1e3 / ns, load);
+        bench_record("blocksize", "SynthEngine", block, kEngineVoices, ns);
+    }
+    printf("\n");
+}
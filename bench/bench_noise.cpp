@@ -0,0 +1,61 @@
+/**
+ * @file bench_noise.cpp
+ * @brief Benchmark of the noise generator.
+ */
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "noisekernel.h"
+
+static const size_t kBlockSize = 256;
+
+void
+bench_noise()
+{
+    std::vector<float> out(kBlockSize), ref(kBlockSize);
+
+    printf("noise generator, block size %zu\n", kBlockSize);
+    printf("%-28s %12s %14s %12s\n", "generator", "ns/sample", "Msamples/s", "same output");
+
+    volatile double sink = 0.0;
+
+    // former generator, global rand() scaled with a division
+    auto ns = bench_ns_per_call([&]() {
+        for (size_t i = 0; i < kBlockSize; i++)
+            out[i] = -1.0f + 2.0f * ((float) rand() / (float) RAND_MAX);
+        sink = out[kBlockSize - 1];
+    }) / kBlockSize;
+    printf("%-28s %12.3f %14.1f %12s\n", "rand()", ns, 1e3 / ns, "-");
+    bench_record("noise", "rand()", kBlockSize, 1, ns);
+
+    // reference output of the portable version, every other version has to match it
+    noiseState state;
+    NoiseKernel::Seed(state, 1);
+    NoiseKernel::ProcessWith(ISA_SCALAR, state, ref.data(), 1.0f, kBlockSize);
+
+    for (int isa = ISA_SCALAR; isa <= ISA_AVX512; isa++)
+    {
+        if (!CpuIsa::IsSupported(isa))
+            continue;
+
+        NoiseKernel::Seed(state, 1);
+        NoiseKernel::ProcessWith(isa, state, out.data(), 1.0f, kBlockSize);
+        auto same = memcmp(out.data(), ref.data(), kBlockSize * sizeof(float)) == 0;
+
+        ns = bench_ns_per_call([&]() {
+            NoiseKernel::ProcessWith(isa, state, out.data(), 1.0f, kBlockSize);
+            sink = out[kBlockSize - 1];
+        }) / kBlockSize;
+
+        char name[64];
+        snprintf(name, sizeof(name), "NoiseKernel %s", CpuIsa::GetName(isa));
+        printf("%-28s %12.3f %14.1f %12s\n", name, ns, 1e3 / ns, same ? "yes" : "NO");
+        bench_record("noise", name, kBlockSize, 1, ns);
+    }
+    printf("\n");
+}
@@ -0,0 +1,87 @@
+/**
+ * @file bench_oversampler.cpp
+ * @brief Benchmark of the oversampling filters.
+ */
+
+//  The cost of Oversampler::Up and Down around an empty stage, for every factor and a range of
+//  filter lengths, and of the FIR kernel behind them for every instruction set.
+
+#include "bench.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+#include "firkernel.h"
+#include "oversampler.h"
+
+static const size_t kBlockSize = 256;
+static const size_t kKernelTaps = 16;
+static const size_t kHalfTaps[] = {4, 8, 12, 16};
+
+void
+bench_oversampler()
+{
+    std::vector<float> signal(kBlockSize);
+    for (size_t i = 0; i < kBlockSize; i++)
+        signal[i] = (float)sin(0.01 * i);
+    std::vector<float> io(kBlockSize);
+    volatile float sink = 0.0f;
+
+    printf("oversampling filters, up and down, block size %zu\n", kBlockSize);
+    printf("%-28s %12s %14s %14s\n", "factor, taps of 1st step", "ns/sample", "Msamples/s", "latency");
+
+    for (size_t factor = 2; factor <= Oversampler::kMaxFactor; factor *= 2)
+    {
+        for (auto half_taps : kHalfTaps)
+        {
+            Oversampler oversampler(kBlockSize, half_taps);
+            oversampler.SetFactor(factor);
+            auto ns = bench_ns_per_call([&]() {
+                for (size_t i = 0; i < kBlockSize; i++)
+                    io[i] = signal[i];
+                oversampler.Process(io.data(), kBlockSize, [](float *, size_t) {});
+                sink = io[kBlockSize - 1];
+            }) / kBlockSize;
+
+            char name[64];
+            snprintf(name, sizeof(name), "%zux, %zu taps", factor, 4 * half_taps - 1);
+            printf("%-28s %12.3f %14.1f %14.2f\n", name, ns, 1e3 / ns, oversampler.GetLatency());
+            bench_record("oversampler", name, kBlockSize, 1, ns);
+        }
+    }
+    printf("\n");
+
+    // the kernel alone, the FMA versions may differ from the portable one in the last bit
+    std::vector<float> coeffs(kKernelTaps), in(kBlockSize + kKernelTaps - 1);
+    std::vector<float> out(kBlockSize), ref(kBlockSize);
+    for (size_t t = 0; t < kKernelTaps; t++)
+        coeffs[t] = 1.0f / (float)(t + 1);
+    for (size_t i = 0; i < in.size(); i++)
+        in[i] = (float)sin(0.37 * i);
+    FirKernel::ProcessWith(ISA_SCALAR, coeffs.data(), kKernelTaps, in.data(), ref.data(), kBlockSize);
+
+    printf("FIR kernel, %zu taps, block size %zu\n", kKernelTaps, kBlockSize);
+    printf("%-28s %12s %14s %14s\n", "kernel", "ns/sample", "Msamples/s", "max error");
+    for (int isa = ISA_SCALAR; isa <= ISA_AVX512; isa++)
+    {
+        if (!CpuIsa::IsSupported(isa))
+            continue;
+
+        FirKernel::ProcessWith(isa, coeffs.data(), kKernelTaps, in.data(), out.data(), kBlockSize);
+        double error = 0.0;
+        for (size_t i = 0; i < kBlockSize; i++)
+            error = fmax(error, fabs((double)out[i] - ref[i]));
+
+        auto ns = bench_ns_per_call([&]() {
+            FirKernel::ProcessWith(isa, coeffs.data(), kKernelTaps, in.data(), out.data(), kBlockSize);
+            sink = out[kBlockSize - 1];
+        }) / kBlockSize;
+
+        char name[64];
+        snprintf(name, sizeof(name), "FirKernel %s", CpuIsa::GetName(isa));
+        printf("%-28s %12.3f %14.1f %14.1e\n", name, ns, 1e3 / ns, error);
+        bench_record("oversampler", name, kBlockSize, 1, ns);
+    }
+    printf("\n");
+}
@@ -0,0 +1,89 @@
+/**
+ * @file bench_sine.cpp
+ * @brief Benchmark of the sine oscillator.
+ */
+
+#include "bench.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+#include "sinekernel.h"
+#include "sinusoid.h"
+
+static const size_t kBlockSize = 256;
+static const int kFs = 48000;
+
+void
+bench_sine()
+{
+    // one block of phases of a 440 Hz oscillator
+    std::vector<float> phase(kBlockSize), out(kBlockSize);
+    double phi = 0.0;
+    for (size_t i = 0; i < kBlockSize; i++)
+    {
+        phase[i] = (float)phi;
+        phi += 2.0 * M_PI * 440.0 / kFs;
+        if (phi >= 2.0 * M_PI)
+            phi -= 2.0 * M_PI;
+    }
+
+    // phases over the whole range, for the error measurement
+    std::vector<float> sweep(1 << 20), sweep_out(sweep.size());
+    for (size_t i = 0; i < sweep.size(); i++)
+        sweep[i] = (float)(2.0 * M_PI * i / sweep.size());
+
+    printf("sine oscillator, block size %zu\n", kBlockSize);
+    printf("%-28s %12s %14s %12s\n", "kernel", "ns/sample", "Msamples/s", "max error");
+
+    volatile double sink = 0.0;
+
+    auto ns = bench_ns_per_call([&]() {
+        double acc = 0.0;
+        for (size_t i = 0; i < kBlockSize; i++)
+            acc += sin((double)phase[i]);
+        sink = acc;
+    }) / kBlockSize;
+    printf("%-28s %12.3f %14.1f %12s\n", "libm sin()", ns, 1e3 / ns, "-");
+    bench_record("sine", "libm sin()", kBlockSize, 1, ns);
+
+    Sinusoid sine(440, 1.0, 0, kFs);
+    ns = bench_ns_per_call([&]() {
+        double acc = 0.0;
+        for (size_t i = 0; i < kBlockSize; i++)
+            acc += sine.getNextSample();
+        sink = acc;
+    }) / kBlockSize;
+    printf("%-28s %12.3f %14.1f %12s\n", "Sinusoid::getNextSample", ns, 1e3 / ns, "-");
+    bench_record("sine", "Sinusoid::getNextSample", kBlockSize, 1, ns);
+
+    ns = bench_ns_per_call([&]() {
+        sine.renderBlock(out.data(), kBlockSize);
+        sink = out[kBlockSize - 1];
+    }) / kBlockSize;
+    printf("%-28s %12.3f %14.1f %12s\n", "Sinusoid::renderBlock", ns, 1e3 / ns, CpuIsa::GetName(CpuIsa::Get()));
+    bench_record("sine", "Sinusoid::renderBlock", kBlockSize, 1, ns);
+
+    for (int isa = ISA_SCALAR; isa <= ISA_AVX512; isa++)
+    {
+        if (!CpuIsa::IsSupported(isa))
+            continue;
+
+        SineKernel::ProcessWith(isa, sweep.data(), sweep_out.data(), sweep.size());
+        double max_error = 0.0;
+        for (size_t i = 0; i < sweep.size(); i++)
+            max_error = fmax(max_error, fabs(sweep_out[i] - sin((double)sweep[i])));
+
+        ns = bench_ns_per_call([&]() {
+            SineKernel::ProcessWith(isa, phase.data(), out.data(), kBlockSize);
+            sink = out[kBlockSize - 1];
+        }) / kBlockSize;
+
+        char name[64];
+        snprintf(name, sizeof(name), "SineKernel %s", CpuIsa::GetName(isa));
+        printf("%-28s %12.3f %14.1f %12.2e\n", name, ns, 1e3 / ns, max_error);
+        bench_record("sine", name, kBlockSize, 1, ns);
+    }
+    printf("\n");
+}
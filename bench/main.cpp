@@ -0,0 +1,40 @@
+/**
+ * @file main.cpp
+ * @brief Entry point of the oscsynth-bench executable.
+ */
+
+//  Build with optimizations, otherwise the numbers are meaningless:
+//      cmake -DCMAKE_BUILD_TYPE=Release ..
+//  With --json FILE all results are written to FILE too, to compare builds.
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+int main(int argc, char *argv[])
+{
+	const char *json = NULL;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+			json = argv[++i];
+		} else {
+			fprintf(stderr, "Usage: %s [--json FILE]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	bench_sine();
+	bench_blep();
+	bench_noise();
+	bench_distortion();
+	bench_oversampler();
+	bench_classes();
+	bench_polyphony();
+	bench_blocksize();
+
+	if (json != NULL && !bench_write_json(json))
+		return 1;
+
+	return 0;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file report.cpp
+ * @brief Collection of the benchmark results and their JSON report.
+ */
+
+//  Every benchmark records its rows next to printing them. The report is a flat list, one object
+//  per row, so two builds can be compared by joining on group, name, block and voices.
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <string>
+
+#include "cpuisa.h"
+
+// one row of a benchmark
+struct benchResult
+{
+    std::string group;
+    std::string name;
+    size_t      block;
+    size_t      voices;
+    double      ns;
+};
+
+static std::vector<benchResult> results;
+
+// writes a string with the characters, which JSON does not allow, escaped
+static void
+write_string(FILE *file, const std::string &s)
+{
+    fputc('"', file);
+    for (auto c : s)
+    {
+        if (c == '"' || c == '\\')
+            fprintf(file, "\\%c", c);
+        else if ((unsigned char)c < 0x20)
+            fprintf(file, "\\u%04x", c);
+        else
+            fputc(c, file);
+    }
+    fputc('"', file);
+}
+
+void
+bench_record(const char *group, const char *name, size_t block, size_t voices, double ns)
+{
+    benchResult result = {group, name, block, voices, ns};
+    results.push_back(result);
+}
+
+bool
+bench_write_json(const char *path)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+    {
+        fprintf(stderr, "could not create %s\n", path);
+        return false;
+    }
+
+    fprintf(file, "{\n  \"isa\": ");
+    write_string(file, CpuIsa::GetName(CpuIsa::Get()));
+    fprintf(file, ",\n  \"results\": [");
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        auto &r = results[i];
+        fprintf(file, "%s\n    {\"group\": ", (i == 0) ? "" : ",");
+        write_string(file, r.group);
+        fprintf(file, ", \"name\": ");
+        write_string(file, r.name);
+        fprintf(file, ", \"block\": %zu, \"voices\": %zu, \"ns_per_sample\": %.4f, \"samples_per_s\": %.1f}",
+                r.block, r.voices, r.ns, 1e9 / r.ns);
+    }
+    fprintf(file, "\n  ]\n}\n");
+
+    auto ok = !ferror(file);
+    return (fclose(file) == 0) && ok;
+}
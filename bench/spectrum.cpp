@@ -0,0 +1,71 @@
+/**
+ * @file spectrum.cpp
+ * @brief Spectral measurements shared by the benchmarks.
+ */
+
+#include "bench.h"
+
+#include <complex>
+#include <math.h>
+
+// in place radix 2 fft
+static void
+fft(std::vector<std::complex<double>> &x)
+{
+    auto n = x.size();
+    for (size_t i = 1, j = 0; i < n; i++)
+    {
+        auto bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(x[i], x[j]);
+    }
+    for (size_t len = 2; len <= n; len <<= 1)
+    {
+        auto w = std::polar(1.0, -2.0 * M_PI / len);
+        for (size_t i = 0; i < n; i += len)
+        {
+            std::complex<double> wk(1.0);
+            for (size_t k = 0; k < len / 2; k++)
+            {
+                auto u = x[i + k];
+                auto v = x[i + k + len / 2] * wk;
+                x[i + k] = u + v;
+                x[i + k + len / 2] = u - v;
+                wk *= w;
+            }
+        }
+    }
+}
+
+double
+alias_energy_db(const std::vector<float> &signal, double f0, double fs)
+{
+    std::vector<std::complex<double>> x(kFftSize);
+    for (size_t i = 0; i < kFftSize; i++)
+    {
+        // 4 term blackman-harris window
+        auto p = 2.0 * M_PI * i / (kFftSize - 1);
+        auto w = 0.35875 - 0.48829 * cos(p) + 0.14128 * cos(2 * p) - 0.01168 * cos(3 * p);
+        x[i] = signal[i] * w;
+    }
+    fft(x);
+
+    // bins closer than this to a harmonic belong to the harmonic
+    const double width = 8.0;
+    double total = 0.0, alias = 0.0;
+    for (size_t b = 1; b < kFftSize / 2; b++)
+    {
+        auto power = std::norm(x[b]);
+        total += power;
+
+        auto f = (double)b * fs / kFftSize;
+        auto k = floor(f / f0 + 0.5);
+        auto harmonic_bin = k * f0 * kFftSize / fs;
+        if (k < 1 || k * f0 >= fs / 2.0 || fabs(b - harmonic_bin) > width)
+            alias += power;
+    }
+    return 10.0 * log10(alias / total);
+}
@@ -36,10 +36,16 @@
 //  A high gain additionally led to distortion, which in some cases was very nice sounding. 
 //  However, we undid this rise of gain to be able to implement a general distortion class. 
 //  This had the effect that the peak gain didn´t increase the signals volume, but in praxis has a similar effect as Q for the other filters.
+//  For a modulated cut off frequency the coefficients of the current type, Q and peak gain are precomputed for
+//  kTableSize log-spaced cut off frequencies. A lookup interpolates linearly between the two neighbours, so the
+//  cut off frequency can change every sample at the cost of a log2 and five multiply-adds instead of tan, sqrt and pow.
+//  The table is rebuilt when the type, Q or peak gain changes.
 
 #pragma once
 
 #include <math.h>
+#include <stddef.h>
+#include <vector>
 
 /**
  * @brief Filter types of the biquad filter.
@@ -58,6 +64,10 @@ enum filterType
 class Biquad
 {
 public:
+    static const size_t kTableSize = 256;       /**< Number of cut off frequencies in the coefficient table. */
+    static constexpr double kTableFcMin = 1e-4; /**< Lowest cut off frequency of the table, relative to fs. */
+    static constexpr double kTableFcMax = 0.49; /**< Highest cut off frequency of the table, relative to fs. */
+
     // CONSTRUCTOR
     /**
      * @brief Standard Constructor.
@@ -122,6 +132,24 @@ public:
      */
     double Process(double in);
 
+    /**
+     * @brief Filter a block of samples in place.
+     * @param io Pointer to the samples.
+     * @param n Number of samples.
+     * @return Return void.
+     */
+    void ProcessBlock(float *io, size_t n);
+
+    /**
+     * @brief Filter a block of samples in place with a cut off frequency per sample, which is
+     *        looked up in the coefficient table. Afterwards the filter keeps the last one.
+     * @param io Pointer to the samples.
+     * @param fc Pointer to the cut off frequencies relative to fs, clamped to the table range.
+     * @param n Number of samples.
+     * @return Return void.
+     */
+    void ProcessBlock(float *io, const float *fc, size_t n);
+
     /**
      * @brief Print the filter type to the screen/file.
      * @return Return void.
@@ -136,11 +164,28 @@ private:
      */
     void calc_biquad();
 
+    /**
+     * @brief Calculate the coefficients of the current type, Q and peak gain for a cut off frequency.
+     * @param fc Cut off frequency relative to fs.
+     * @param c Returns a0, a1, a2, b1 and b2.
+     * @return Return void.
+     */
+    void calc_coeffs(double fc, double *c) const;
+
+    /**
+     * @brief Rebuild the coefficient table and the gain reduction factor.
+     * @return Return void.
+     */
+    void build_table();
+
     int     type_;                      /**< Type of the filter. */
     double  a0_, a1_, a2_, b1_, b2_;    /**< Filter coefficients. */
     double  fc_, q_, peak_gain_;        /**< Cut off frequency; q value; peak gain. */
     double  z1_, z2_;                   /**< Z delays. */
     bool    gain_reduce_;               /**< If a gain reduction is applied or not. */
+    double  gain_reduce_factor_;        /**< Gain reduction factor, 1 / (10^(peak gain / 20)). */
+
+    std::vector<double> table_;         /**< a0, a1, a2, b1 and b2 for every table cut off frequency. */
 };
 
 /**
@@ -157,7 +202,7 @@ Biquad::Process(double in)
     // 	Section to reduce gain in areas where peak gain was applied earlier. 
     //	This leads to a reduction of the volume, however a high peakGain then works similar to the Q factor
     if (gain_reduce_)
-    	out = out / pow(10, peak_gain_/20);
+    	out = out * gain_reduce_factor_;
     
     return out;
 }
@@ -4,9 +4,19 @@
  * @brief ADSR class represents the envelope of a synthesizer, which shapes the sound over time.
  */
 
+//  Attack, decay and release multiply the output every sample with a constant factor, so the
+//  segments are exponential curves. The factors only change with the times and the sample rate,
+//  they are calculated in the setters. The curves are defined at kReferenceRate, at any other
+//  sample rate the factor is raised to the power kReferenceRate / fs, which keeps their duration.
+//  \ref ProcessBlock computes in closed form how many samples remain until the output crosses
+//  the threshold of the segment (log(threshold / output) / log(factor)) and renders that many
+//  with one multiplication each. Only the samples around a state change go through \ref Process,
+//  which checks the thresholds. No transcendental function is evaluated per sample.
+
 #pragma once
 
 #include <math.h>
+#include <stddef.h>
 
 // states of the ADSR
 enum noteState
@@ -30,23 +40,53 @@ private:
     float   decay_time_;                /**< Decay time. */
     float   sustain_level_;             /**< Sustain level. */
     float   release_time_;              /**< Release time. */
+
+    float   fs_;                        /**< Sample rate. */
+    float   attack_factor_;             /**< Factor of the output per sample during attack. */
+    float   decay_factor_;              /**< Factor of the output per sample during decay. */
+    float   release_factor_;            /**< Factor of the output per sample during release. */
+
+    /**
+     * @brief Calculate the factors of the segments from the times and the sample rate.
+     * @return Return void.
+     */
+    void    update_factors();
+
+    /**
+     * @brief Number of samples, which can be rendered in the current segment without reaching its threshold.
+     * @param factor Factor of the output per sample.
+     * @param threshold Output at which the segment ends.
+     * @param max Maximum number of samples.
+     * @return Return the number of samples, at most max.
+     */
+    size_t  samples_before(float factor, float threshold, size_t max);
     
 public:
+    static constexpr float kReferenceRate = 48000.0f;  /**< Sample rate, at which the times are defined. */
+
     // CONSTRUCTEUR & DESCTRUCTOR
 	ADSR();
     ~ADSR();
 
     /**
-     * @brief   Inline process function, which returns the value which the signal is muliplied with.
+     * @brief   Process function, which returns the value which the signal is muliplied with.
      *          The calculation depends on the envelope state and the following attributes:
-     *              attack_time_
-     *              decay_time_
+     *              attack_factor_
+     *              decay_factor_
      *              sustain_level_
-     *              release_time_
+     *              release_factor_
      * @return Return the output as a float.
      */
 	float Process();
 
+    /**
+     * @brief Multiply a block of samples with the envelope.
+     * @param io Pointer to the samples, which are processed in place.
+     * @param n Number of samples.
+     * @return Return void.
+     */
+    void ProcessBlock(float *io, size_t n);
+
     /**
      * @brief Reset or init the ADSR.
      * @return Return void.
@@ -72,21 +112,21 @@ public:
      * @param t attack time, as a float, range from 1.0f to 99.0f.
      * @return Return void.
      */
-    void    SetAttack(float t)      { attack_time_ = t; };
+    void    SetAttack(float t)      { attack_time_ = t; update_factors(); };
 
     /**
      * @brief Set the attack time.
      * @param t decay time, as a float, range from 1.0f to 99.0f.
      * @return Return void.
      */
-    void    SetDecay(float t)       { decay_time_ = t; };
+    void    SetDecay(float t)       { decay_time_ = t; update_factors(); };
 
     /**
      * @brief Set the attack time.
      * @param t release time, as a float, range from 1.0f to 99.0f.
      * @return Return void.
      */
-    void    SetRelease(float t)     { release_time_ = t; };
+    void    SetRelease(float t)     { release_time_ = t; update_factors(); };
 
     /**
      * @brief Set the sustain level.
@@ -95,6 +135,13 @@ public:
      */
     void    SetSustain(float level) { sustain_level_ = level; };
 
+    /**
+     * @brief Set the sample rate.
+     * @param fs Sample rate in Hz.
+     * @return Return void.
+     */
+    void    SetSampleRate(float fs) { fs_ = fs; update_factors(); };
+
     /**
      * @brief Set the state. See \ref noteState
      * @param state The state of the ADSR, e.g. can be noteState::NOTE_OFF, noteState::ATTACK etc.
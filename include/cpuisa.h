@@ -0,0 +1,46 @@
+/**
+ * @file cpuisa.h
+ * @brief CpuIsa detects the vector instruction sets of the cpu, shared by all SIMD kernels.
+ */
+
+//  The kernels (SineKernel, NoiseKernel, FirKernel) are built as plain C++ and as SSE2, AVX2/FMA
+//  and AVX-512 versions with target attributes, so the binary needs no -m flags. Which version
+//  runs is decided here, once, for all of them. On other architectures only the portable
+//  version exists and ISA_SCALAR is reported.
+
+#pragma once
+
+/**
+ * @brief Instruction sets of the SIMD kernels, in increasing order.
+ */
+enum cpuIsa
+{
+    ISA_SCALAR = 0,             /**< Portable C++. */
+    ISA_SSE2 = 1,               /**< SSE2, 4 floats per instruction. */
+    ISA_AVX2 = 2,               /**< AVX2 and FMA, 8 floats per instruction. */
+    ISA_AVX512 = 3              /**< AVX-512F, 16 floats per instruction. */
+};
+
+class CpuIsa
+{
+public:
+    /**
+     * @brief Get the best instruction set of this cpu, which the kernels use by default.
+     * @return Return the instruction set as an int, see \ref cpuIsa.
+     */
+    static int  Get();
+
+    /**
+     * @brief Check if an instruction set is supported by the cpu and by this build.
+     * @param isa Instruction set, see \ref cpuIsa.
+     * @return Return true if supported.
+     */
+    static bool IsSupported(int isa);
+
+    /**
+     * @brief Get the name of an instruction set.
+     * @param isa Instruction set, see \ref cpuIsa.
+     * @return Return the name as a c string.
+     */
+    static const char *GetName(int isa);
+};
@@ -1,45 +1,17 @@
 #pragma once
 
-#include <string>
+#include <stdint.h>
 
 /**
- * @brief Struct for osc double messages.
+ * @brief Struct for midi messages, packed into 8 bytes.
  */
-struct dMess
+struct midiEvent
 {
-    std::string type;       /**< Message value type. */
-    std::string path;       /**< Message path / command. */
-    double val;             /**< Message data. */
+	uint32_t time;          /**< Arrival time in microseconds of the monotonic clock, wraps after 71 minutes. */
+	uint8_t status;         /**< Status byte. */
+	uint8_t data1;          /**< Data byte 1, e.g. the note. */
+	uint8_t data2;          /**< Data byte 2, e.g. the velocity. */
+	uint8_t size;           /**< Number of valid bytes, 1 to 3. */
 };
 
-/**
- * @brief Struct for osc integer messages.
- */
-struct iMess
-{
-    std::string type;       /**< Message value type. */
-    std::string path;       /**< Message path / command. */
-    int val;                /**< Message data. */
-};
-
-/**
- * @brief Struct for osc char messages.
- */
-struct sMess
-{
-    std::string type;       /**< Message value type. */
-    std::string path;       /**< Message path / command. */
-    char val;               /**< Message data. */
-};
-
-/**
- * @brief Struct for midi messages.
- */
-struct midiMessage
-{
-	int byte1;              /**< Status byte. */
-	int byte2;              /**< Data byte 1. */
-	double byte3;           /**< Data byte 2. */
-	double stamp;           /**< Time stamp. */
-	bool hasBeenProcessed;  /**< Whether the midi event is processed or not. */
-};
+static_assert(sizeof(midiEvent) == 8, "midi events are packed into 8 bytes");
@@ -4,10 +4,45 @@
  * @brief Distortion class can be used to give the sound more color, by manipulation e.g. the gain.
  */
 
+//  The curve is the blend of the atan of the input and the input itself. The atan comes from
+//  a Waveshaper table and the blend factors are calculated in the setter, so a sample costs one
+//  table interpolation and two multiplications. The curve adds harmonics far above nyquist, which
+//  would fold back into the audio band, so \ref ProcessBlock can run it at 2, 4 or 8 times the
+//  sample rate, see Oversampler. The block is processed in chunks of kChunkSize samples, so the
+//  oversampling buffers have a fixed size, whatever the period.
+//  The other models suppress the aliasing at the base rate with antiderivative anti-aliasing
+//  (ADAA): instead of the curve at the samples, the output is its average over the straight line
+//  between two inputs, the difference of the antiderivative divided by the difference of the
+//  inputs. Averaging is a lowpass applied before the curve is sampled, so the harmonics above
+//  nyquist are damped. The second order averages the first order once more, with the second
+//  antiderivative; it damps more and costs about as much, since the difference of the previous
+//  sample is kept. Where the inputs are too close, the quotient loses its precision and the curve
+//  at the mean of the inputs is used instead. The first order delays by half a sample, the second
+//  by one; the unshaped part of the blend is averaged the same way, so the two stay aligned.
+//  Drive is the gain in front of the curve.
+
 #pragma once
 
 #include <iostream>
 #include <cmath>
+#include <stddef.h>
+
+#include "oversampler.h"
+#include "waveshaper.h"
+
+/**
+ * @brief Curves of the distortion.
+ */
+enum distortionModel
+{
+    DISTORTION_ATAN = 0,            /**< atan from a table, may be oversampled. */
+    DISTORTION_ATAN_ADAA1 = 1,      /**< atan, first order ADAA. */
+    DISTORTION_ATAN_ADAA2 = 2,      /**< atan, second order ADAA. */
+    DISTORTION_TANH = 3,            /**< tanh, first order ADAA. */
+    DISTORTION_HARDCLIP = 4,        /**< Clipping at +-1, first order ADAA. */
+    DISTORTION_WAVEFOLDER = 5,      /**< Triangle folding into +-1, first order ADAA. */
+    DISTORTION_MODEL_COUNT = 6      /**< Number of models. */
+};
 
 class Distortion {
 public:
@@ -53,16 +88,103 @@ public:
     void SetBlend(double blend);
 
     /**
-     * @brief Process a value and return the distorted value.
+     * @brief Set the oversampling factor of \ref ProcessBlock.
+     * @param factor 1 (off), 2, 4 or 8.
+     * @return Return void.
+     */
+    void SetOversampling(size_t factor)     { oversampler_.SetFactor(factor); };
+
+    /**
+     * @brief Set the curve, the history of the ADAA models starts from silence.
+     * @param model Curve, see \ref distortionModel, other values are ignored.
+     * @return Return void.
+     */
+    void SetModel(int model);
+
+    /**
+     * @brief Process a value and return the distorted value with the table atan, without
+     *        oversampling or ADAA.
      * @param in Input value as a double.
      * @return Return distorted value as a double.
      */
     double Process(double in);
 
+    // GETTER
+    /**
+     * @brief Get the oversampling factor.
+     * @return Return the factor as a size_t.
+     */
+    size_t GetOversampling()                { return oversampler_.GetFactor(); };
+
+    /**
+     * @brief Get the curve.
+     * @return Return the \ref distortionModel as an int.
+     */
+    int GetModel()                          { return model_; };
+
+    /**
+     * @brief Get the delay of \ref ProcessBlock, of the oversampling filters and the ADAA.
+     * @return Return the delay in samples as a double.
+     */
+    double GetLatency();
+
+    /**
+     * @brief Distort a block of samples in place.
+     * @param io Pointer to the samples.
+     * @param n Number of samples.
+     * @return Return void.
+     */
+    void ProcessBlock(float *io, size_t n);
+
+    /**
+     * @brief Distort a block of samples in place with std::atan of the driven sample at the
+     *        base rate, the curve of the table computed directly, kept as the reference of the
+     *        benchmark. Unlike the former implementation, which ignored the drive, it applies it.
+     * @param io Pointer to the samples.
+     * @param n Number of samples.
+     * @return Return void.
+     */
+    void ProcessBlockAtan(float *io, size_t n);
+
+    static const size_t kChunkSize = 64;    /**< Base rate samples processed at once. */
+
 private:
+    /**
+     * @brief Apply the curve to a block at the current rate.
+     * @param io Pointer to the samples.
+     * @param n Number of samples.
+     * @return Return void.
+     */
+    void shape(float *io, size_t n);
+
+    /**
+     * @brief Apply a curve with first order ADAA.
+     * @param io Pointer to the samples.
+     * @param n Number of samples.
+     * @return Return void.
+     */
+    template <typename Curve>
+    void adaa1(float *io, size_t n);
+
+    /**
+     * @brief Apply a curve with second order ADAA.
+     * @param io Pointer to the samples.
+     * @param n Number of samples.
+     * @return Return void.
+     */
+    template <typename Curve>
+    void adaa2(float *io, size_t n);
+
     double drive_;      /**< Drive of the distortion. */
     double range_;      /**< Range of the distortion. */
     double blend_;      /**< Blend of the distortion. */
+    float  wet_;        /**< Factor of the shaped input, blend. */
+    float  dry_;        /**< Factor of the input, 1 / blend. */
+    int    model_;      /**< Curve, see \ref distortionModel. */
+    double prev_[2];    /**< Last and second to last input of the ADAA models. */
+
+    Waveshaper  shaper_;        /**< atan table. */
+    Oversampler oversampler_;   /**< Rate conversion around the curve. */
 
 };
 
@@ -73,8 +195,5 @@ inline
 double
 Distortion::Process(double in)
 {
-    auto out = in;
-    out = (((2.0 / M_PI) * std::atan(out) * blend_) + (in * (1.0 / blend_)));
-
-    return out;
+    return wet_ * shaper_.Process((float)(drive_ * in)) + dry_ * in;
 }
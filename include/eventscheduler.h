@@ -0,0 +1,101 @@
+/**
+ * @file eventscheduler.h
+ * @brief EventScheduler class orders the control events of one period by their frame.
+ */
+
+//  All events of a period are collected with their position in frames, which may be
+//  fractional, and sorted once. The renderer then renders the voices up to the first sample at
+//  or after each event, applies the event and continues, so the period is split into sub-blocks
+//  at the event boundaries. The fraction between the event and that first sample is handed to
+//  the event, e.g. a note-on advances the phase of its oscillators by it. An event after the
+//  last sample of the period (frame in (n - 1, n) or later) has no such sample; it is kept by
+//  \ref Advance and applied at the start of the next period with the remaining fraction.
+//  The events are kept in a fixed array, collecting and sorting never allocates.
+
+#pragma once
+
+#include <stddef.h>
+
+#include "synthcommand.h"
+
+/**
+ * @brief Control event with its position within the period.
+ */
+struct scheduledEvent
+{
+    double          frame;      /**< Position in frames from the start of the period, may be fractional. */
+    synthCommand    cmd;        /**< Event. */
+};
+
+class EventScheduler
+{
+public:
+    static const size_t kMaxEvents = 256;       /**< Events per period. */
+
+    // CONSTRUCTOR
+    /**
+     * @brief Standard Constructor, no events.
+     */
+    EventScheduler();
+
+    // DESCTRUCTOR
+    /**
+     * @brief Standard Destructor.
+     */
+    ~EventScheduler();
+
+    /**
+     * @brief Remove all events, at the start of a period.
+     * @return Return void.
+     */
+    void Clear()                { count_ = 0; };
+
+    /**
+     * @brief Remove the first events, which were applied, and move the others n frames earlier,
+     *        at the end of a period of n frames. Their frames become negative, if they lie less
+     *        than a frame after the period.
+     * @param applied Number of events applied, after \ref Sort.
+     * @param n Length of the period in frames.
+     * @return Return void.
+     */
+    void Advance(size_t applied, size_t n);
+
+    /**
+     * @brief Add an event.
+     * @param frame Position in frames from the start of the period, at least 0.
+     * @param cmd Event.
+     * @return Return false if the scheduler is full or the frame is negative, the event is
+     *         dropped then.
+     */
+    bool Add(double frame, const synthCommand &cmd);
+
+    /**
+     * @brief Sort the events by frame. Events at the same frame keep the order they were added in.
+     * @return Return void.
+     */
+    void Sort();
+
+    // GETTER
+    /**
+     * @brief Get the number of events.
+     * @return Return the number of events as a size_t.
+     */
+    size_t  GetCount()          { return count_; };
+
+    /**
+     * @brief Get the number of events, which can still be added.
+     * @return Return the number of free places as a size_t.
+     */
+    size_t  GetFree()           { return kMaxEvents - count_; };
+
+    /**
+     * @brief Get an event, after \ref Sort in the order of their frames.
+     * @param i Index of the event.
+     * @return Return a reference to the event.
+     */
+    const scheduledEvent &Get(size_t i)     { return events_[i]; };
+
+private:
+    scheduledEvent  events_[kMaxEvents];        /**< Events of the period. */
+    size_t          count_;                     /**< Number of events. */
+};
@@ -0,0 +1,47 @@
+/**
+ * @file firkernel.h
+ * @brief FirKernel computes a block of outputs of a short FIR filter.
+ */
+
+//  out[i] = sum over t of coeffs[t] * in[i + t], the input holds the history in front of the
+//  block. The kernels run over the outputs, one vector of outputs per accumulator: a tap is one
+//  broadcast coefficient, one unaligned load and one multiply-add per vector, and there is no
+//  horizontal sum. Four accumulators are in flight, so the latency of the multiply-add is hidden.
+//  The versions are plain C++, SSE2 (4 outputs per instruction), AVX2/FMA (8) and AVX-512 (16),
+//  picked at runtime by CpuIsa. The FMA versions round once per tap instead of twice, so
+//  their results differ from the others in the last bit.
+
+#pragma once
+
+#include <stddef.h>
+
+#include "cpuisa.h"
+
+class FirKernel
+{
+public:
+    /**
+     * @brief Compute out[i] = sum of coeffs[t] * in[i + t] with the best instruction set of this cpu.
+     * @param coeffs Pointer to the coefficients, in the order they meet the input.
+     * @param taps Number of coefficients.
+     * @param in Pointer to n + taps - 1 input samples.
+     * @param out Pointer to the n output samples, must not overlap in.
+     * @param n Number of outputs.
+     * @return Return void.
+     */
+    static void Process(const float *coeffs, size_t taps, const float *in, float *out, size_t n);
+
+    /**
+     * @brief Compute the filter with a specific instruction set, e.g. for benchmarks.
+     *        The instruction set has to be supported, see \ref CpuIsa::IsSupported.
+     * @param isa Instruction set, see \ref cpuIsa.
+     * @param coeffs Pointer to the coefficients.
+     * @param taps Number of coefficients.
+     * @param in Pointer to n + taps - 1 input samples.
+     * @param out Pointer to the n output samples.
+     * @param n Number of outputs.
+     * @return Return void.
+     */
+    static void ProcessWith(int isa, const float *coeffs, size_t taps, const float *in, float *out,
+                            size_t n);
+};
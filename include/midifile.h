@@ -0,0 +1,97 @@
+/**
+ * @file midifile.h
+ * @brief MidiFile class reads the channel messages of a Standard MIDI File with their time in seconds.
+ */
+
+//  Format 0 and 1 files are read completely at load time: the tracks are parsed (running
+//  status, sysex and meta events are skipped, except set tempo), the channel messages of all
+//  tracks are merged by tick, messages at the same tick keep the order of their tracks, and
+//  the ticks are converted to seconds with the tempo map. Files with an SMPTE time division
+//  have a fixed number of ticks per second and ignore the tempo.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief Channel message of a midi file.
+ */
+struct midiFileEvent
+{
+    double      time;       /**< Time from the start of the file in seconds. */
+    uint8_t     status;     /**< Status byte, with the channel. */
+    uint8_t     data1;      /**< First data byte. */
+    uint8_t     data2;      /**< Second data byte, 0 for messages with one data byte. */
+};
+
+class MidiFile
+{
+public:
+    // CONSTRUCTOR
+    /**
+     * @brief Standard Constructor, no events.
+     */
+    MidiFile();
+
+    // DESCTRUCTOR
+    /**
+     * @brief Standard Destructor.
+     */
+    ~MidiFile();
+
+    /**
+     * @brief Read a file, the events of a previous file are removed.
+     * @param path Path of the file.
+     * @return Return false if the file cannot be read or is no valid midi file.
+     */
+    bool Load(const char *path);
+
+    // GETTER
+    /**
+     * @brief Get the number of channel messages.
+     * @return Return the number as a size_t.
+     */
+    size_t GetCount()                           { return events_.size(); };
+
+    /**
+     * @brief Get a channel message, ordered by time.
+     * @param i Index, below \ref GetCount.
+     * @return Return the event.
+     */
+    const midiFileEvent &Get(size_t i)          { return events_[i]; };
+
+    /**
+     * @brief Get the time of the last event of any track, including the end of track events.
+     * @return Return the length in seconds as a double.
+     */
+    double GetLength()                          { return length_; };
+
+private:
+    /**
+     * @brief Event of a track with its time in ticks.
+     */
+    struct tickEvent
+    {
+        uint64_t    tick;       /**< Time from the start in ticks. */
+        uint32_t    tempo;      /**< Microseconds per quarter note of a set tempo event, 0 otherwise. */
+        uint8_t     status;     /**< Status byte of a channel message. */
+        uint8_t     data1;      /**< First data byte. */
+        uint8_t     data2;      /**< Second data byte. */
+    };
+
+    /**
+     * @brief Parse one track chunk and append its events.
+     * @param data Pointer to the data of the chunk.
+     * @param size Size of the chunk in bytes.
+     * @param events Events of all tracks.
+     * @param end_tick Latest end of all tracks in ticks, updated.
+     * @return Return false if the track is truncated.
+     */
+    static bool read_track(const uint8_t *data, size_t size, std::vector<tickEvent> &events,
+                           uint64_t &end_tick);
+
+    std::vector<midiFileEvent>  events_;    /**< Channel messages of all tracks, by time. */
+    double                      length_;    /**< Length in seconds. */
+};
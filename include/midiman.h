@@ -7,29 +7,41 @@
 #define MIDIMAN_H
 
 #include "datatypes.h"
+#include "spscqueue.h"
 #include <RtMidi.h>
 #include <unistd.h>
 
 class MidiMan {
 public:
 
+    // capacity of the event ring
+    static const size_t kQueueSize = 1024;
+
     //constructor
     MidiMan();
     //Dectructor
     ~MidiMan();
 
+    // Copies up to max pending events, oldest first, into events and returns their number.
+    // Wait-free, call it from one thread only.
+    size_t drainEvents(midiEvent *events, size_t max);
 
-    void flushProcessedMessages();
+    // Current time of the monotonic clock in microseconds, like midiEvent::time
+    static uint32_t now();
 
-    midiMessage get_rtmidi();
+    // Number of events, which were lost because the ring was full
+    size_t getOverflows() { return events.GetOverflows(); }
 
     void setVerbose();
 
 private:
+    // RtMidi calls this from its own thread for every incoming message
+    static void midiCallback(double deltatime, std::vector<unsigned char> *message, void *userData);
+
     // rtmidi
     RtMidiIn *midiin;
-    int nBytes, i;
-    double stamp;
+    // events from the RtMidi thread to the thread, which drains them
+    SpscQueue<midiEvent> events;
     bool isVerbose;
 
 
@@ -0,0 +1,136 @@
+/**
+ * @file modmatrix.h
+ * @brief ModMatrix class routes modulation sources to the synthesizer parameters.
+ */
+
+//  A route adds a source value times its depth to a parameter. Every parameter has a base value,
+//  the last value set with a command, and its modulated value is the base plus the sum of all
+//  routes to it. Sources and parameters are plain indices, the routes are kept in three flat
+//  arrays (source, target, depth), so \ref Evaluate is one pass over the routes without any
+//  branch or indirection beyond the two array lookups.
+//  The matrix is evaluated at a fixed control rate, counted in samples, so the result does not
+//  depend on the period size or on when a thread happens to run. Routes are changed only by the
+//  thread which evaluates the matrix, or before it starts.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "synthcommand.h"
+
+/**
+ * @brief Modulation sources.
+ */
+enum modSource
+{
+    MOD_SRC_LFO = 0,            /**< Lfo, -1 to 1. */
+    MOD_SRC_ENVELOPE,           /**< Level of the voice of the last note, 0 to 1. */
+    MOD_SRC_VELOCITY,           /**< Velocity of the last note, 0 to 1. */
+    MOD_SRC_CC,                 /**< Midi controller 0, followed by the other 127, 0 to 1. */
+    MOD_SRC_COUNT = MOD_SRC_CC + 128    /**< Number of sources. */
+};
+
+class ModMatrix
+{
+public:
+    static const size_t kMaxRoutes = 512;       /**< Maximum number of routes. */
+
+    // CONSTRUCTOR
+    /**
+     * @brief Standard Constructor, no routes, all sources and base values are 0.
+     */
+    ModMatrix();
+
+    // DESCTRUCTOR
+    /**
+     * @brief Standard Destructor.
+     */
+    ~ModMatrix();
+
+    /**
+     * @brief Add a route.
+     * @param source Modulation source, see \ref modSource.
+     * @param target Parameter, see \ref synthParam.
+     * @param depth Factor of the source value, in units of the parameter.
+     * @return Return the index of the route, or -1 if source or target are invalid or the matrix is full.
+     */
+    int  AddRoute(int source, int target, float depth);
+
+    /**
+     * @brief Remove all routes.
+     * @return Return void.
+     */
+    void ClearRoutes();
+
+    /**
+     * @brief Calculate the modulated value of all parameters from the current sources.
+     * @return Return void.
+     */
+    void Evaluate();
+
+    // SETTER
+    /**
+     * @brief Set the value of a source.
+     * @param source Modulation source, see \ref modSource.
+     * @param value Value.
+     * @return Return void.
+     */
+    void SetSource(int source, float value);
+
+    /**
+     * @brief Set the unmodulated value of a parameter.
+     * @param target Parameter, see \ref synthParam.
+     * @param value Value.
+     * @return Return void.
+     */
+    void SetBase(int target, float value);
+
+    /**
+     * @brief Set the depth of a route.
+     * @param route Index of the route, returned by \ref AddRoute.
+     * @param depth Factor of the source value.
+     * @return Return void.
+     */
+    void SetDepth(size_t route, float depth);
+
+    // GETTER
+    /**
+     * @brief Get the modulated value of a parameter, as of the last \ref Evaluate.
+     * @param target Parameter, see \ref synthParam.
+     * @return Return the value as a float.
+     */
+    float   GetValue(int target)        { return value_[target]; };
+
+    /**
+     * @brief Get the number of routes.
+     * @return Return the number of routes as a size_t.
+     */
+    size_t  GetRouteCount()             { return route_count_; };
+
+    /**
+     * @brief Get the number of parameters, which are the target of at least one route.
+     * @return Return the number of targets as a size_t.
+     */
+    size_t  GetTargetCount()            { return target_count_; };
+
+    /**
+     * @brief Get a parameter, which is the target of a route.
+     * @param i Index, 0 to \ref GetTargetCount - 1.
+     * @return Return the parameter id.
+     */
+    int     GetTarget(size_t i)         { return targets_[i]; };
+
+private:
+    float       sources_[MOD_SRC_COUNT];        /**< Current value of every source. */
+    float       base_[PARAM_COUNT];             /**< Unmodulated value of every parameter. */
+    float       value_[PARAM_COUNT];            /**< Modulated value of every parameter. */
+
+    uint16_t    route_source_[kMaxRoutes];      /**< Source of every route. */
+    uint16_t    route_target_[kMaxRoutes];      /**< Target of every route. */
+    float       route_depth_[kMaxRoutes];       /**< Depth of every route. */
+    size_t      route_count_;                   /**< Number of routes. */
+
+    int         targets_[PARAM_COUNT];          /**< Parameters with at least one route. */
+    size_t      target_count_;                  /**< Number of these parameters. */
+};
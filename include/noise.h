@@ -5,13 +5,17 @@
 #ifndef NOISE_H
 #define NOISE_H
 
-#include <stdlib.h>     /* srand, rand */
+#include <stddef.h>
+#include <stdint.h>
+
+#include "noisekernel.h"
 
 #define _USE_MATH_DEFINES
 
 class Noise {
 public:
-    Noise(double a);
+    // a is the amplitude, seed selects the sequence, the same seed gives the same samples
+    Noise(double a, uint32_t seed = 1);
     void proceed(double ms);
 
     /// getters
@@ -22,6 +26,9 @@ public:
     double getNextSample();
     double getCurrentAmpl();
 
+    /// render the next n samples into out
+    void renderBlock(float *out, size_t n);
+
 
 private:
 
@@ -34,6 +41,9 @@ private:
 
     double *t;
 
+    // state of the generator, owned by this object, no global rand()
+    noiseState state;
+
 
 };
 
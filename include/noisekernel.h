@@ -0,0 +1,78 @@
+/**
+ * @file noisekernel.h
+ * @brief NoiseKernel fills whole blocks with white noise from a per-voice xorshift generator.
+ */
+
+//  Every generator consists of kLanes independent xorshift32 states; sample i of a block is
+//  taken from lane i % kLanes, so one group of kLanes samples advances every lane once. The
+//  upper 23 bits of a state become the mantissa of a float in [1, 2), which is mapped to
+//  [-1, 1) with one subtraction (exact) and one multiplication, no division and no int to float
+//  conversion.
+//  The lanes are updated with integer shifts and xors only, 4 per instruction with SSE2, 8 with
+//  AVX2 and 16 with AVX-512; there are more lanes than fit into one vector, so several vectors
+//  are in flight and the latency of the xorshift chain is hidden. The versions compute the same
+//  operations in the same order, so a seed gives the same samples on every machine (\ref Mix
+//  may round the final addition differently where the compiler fuses it with the
+//  multiplication).
+//  The state belongs to its owner (one per voice), so there is no shared or locked state like
+//  the one of rand(), and the generators can run in any number of threads.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cpuisa.h"
+
+/**
+ * @brief State of one noise generator.
+ */
+struct noiseState
+{
+    static const size_t kLanes = 64;        /**< Independent xorshift32 generators. */
+    uint32_t lane[kLanes];                  /**< State of every lane, never 0. */
+};
+
+class NoiseKernel
+{
+public:
+    /**
+     * @brief Seed a generator, every seed gives a different sequence.
+     * @param state Generator.
+     * @param seed Seed.
+     * @return Return void.
+     */
+    static void Seed(noiseState &state, uint32_t seed);
+
+    /**
+     * @brief Compute out[i] = gain * noise with the best instruction set of this cpu.
+     * @param state Generator.
+     * @param out Pointer to the output samples.
+     * @param gain Amplitude of the noise.
+     * @param n Number of samples.
+     * @return Return void.
+     */
+    static void Process(noiseState &state, float *out, float gain, size_t n);
+
+    /**
+     * @brief Compute out[i] += gain * noise with the best instruction set of this cpu.
+     * @param state Generator.
+     * @param out Pointer to the samples, which the noise is added to.
+     * @param gain Amplitude of the noise.
+     * @param n Number of samples.
+     * @return Return void.
+     */
+    static void Mix(noiseState &state, float *out, float gain, size_t n);
+
+    /**
+     * @brief Compute out[i] = gain * noise with a specific instruction set, e.g. for benchmarks.
+     *        The instruction set has to be supported, see \ref CpuIsa::IsSupported.
+     * @param isa Instruction set, see \ref cpuIsa.
+     * @param state Generator.
+     * @param out Pointer to the output samples.
+     * @param gain Amplitude of the noise.
+     * @param n Number of samples.
+     * @return Return void.
+     */
+    static void ProcessWith(int isa, noiseState &state, float *out, float gain, size_t n);
+};
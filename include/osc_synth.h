@@ -2,65 +2,58 @@
 
 #include <jackaudioio.hpp>
 #include <algorithm>
+#include <atomic>
 #include <unistd.h>
-#include <map>
-#include <memory>
 
-#include "oscicontainer.h"
+#include "synthengine.h"
+#include "synthcommand.h"
 #include "oscman.h"
 #include "midiman.h"
-#include "Biquad.h"
-#include "sinusoid.h"
-#include "distortion.h"
-#include "adsr.h"
-
-//Preset Numbers
-enum presetnumber{
-    wobble = 		1,
-    dreamy = 		2,
-    nice_pulse=		3,
-    in_the_night=	4,
-    high_hat=		5,
-};
 
 
 class OSCSynth: public JackCpp::AudioIO {
 
 private:
-	std::map<int, std::unique_ptr<Oscicontainer>> osci;
+	// voices, modulation and effects, the jack independent part of the synthesizer
+	SynthEngine *engine_;
 	OscMan *osc;
-
 	MidiMan *midi;
-	Biquad *filter;
-	Oscicontainer *lfo;
-	Distortion* distortion;
-
-	bool filterStatus;
-	bool distortion_status_;
 
-	jack_nframes_t fs;
-	jack_nframes_t nframes;
-	double gain_;
+	// true: audioCallback renders the period itself, false: process() fills the ring buffer
+	bool direct_;
+	// optional jack midi input, read in the jack callback, NULL if RtMidi is used
+	jack_port_t *midi_port_;
 
-	// variables for midi handling
-	double t_tracking; //time tracker
-	int counter; //counter for the number of used oscillators
-	size_t maxAnzahl_Osci;// max number of availible oscillators
+	// control events reach the rendering thread without a detour over the main thread:
+	// midi events through the ring of the MidiMan, osc parameters through the slot table of the OscMan,
+	// osc routes through the queue of the OscMan
+	size_t reported_overflows_; // dropped midi events, which have been logged
+	size_t reported_route_overflows_; // dropped osc routes, which have been logged
+	// events refused by the full scheduler of the engine, counted in the rendering thread
+	std::atomic<size_t> dropped_events_;
+	size_t reported_dropped_;   // dropped events, which have been logged
 
-	// vecors for midi handling
-	std::vector<int> Noten;
-	std::vector<int> freeOsci;
-	std::vector<double> timetracker;
+	// monotonic time of the start of the last period in microseconds, see MidiMan::now()
+	uint32_t period_time_;
 
-	// variables for osc handling
-	double valOld;
-	std::string typeOld;
-	std::string pathOld;
-	double lfo_oldValue = 0.0;
+	jack_nframes_t fs;
+	jack_nframes_t nframes;
 
 	// Ring buffer output
 	JackCpp::RingBuffer<float>* ring_buffer_out_;
 
+	// one jack period of the synthesizer output
+	std::vector<float> block_;
+
+	// renders one period of n samples (at most the buffer size), after scheduling the pending
+	// control events in the engine, jack_midi is the buffer of the jack midi port or NULL
+	void renderPeriod(float *out, size_t n, void *jack_midi = NULL);
+	// takes the pending midi events and schedules them in the period of n samples,
+	// leaving reserve places of the scheduler free for the jack midi events
+	void midiHandler(size_t n, size_t reserve = 0);
+	// schedules an event in the next period and counts it, if the engine refuses it
+	void schedule(double frame, const synthCommand &cmd);
+
 public:
 
     /// Declaration of Audio Callback Function:
@@ -70,27 +63,29 @@ public:
                               // A vector of pointers to each output port.
                               audioBufVector outBufs); 
 
-    /// Constructor
-	OSCSynth();
+    /// Maximum polyphony
+	static const size_t kMaxVoices = SynthEngine::kMaxVoices;
+    /// Number of midi events taken from the MidiMan at once
+	static const size_t kMidiBatch = 64;
+    /// Number of osc routes taken from the OscMan at once
+	static const size_t kRouteBatch = 16;
+    /// Maximum number of rendering threads
+	static const size_t kMaxThreads = SynthEngine::kMaxThreads;
+
+    /// Constructor, voices is the polyphony (1 to kMaxVoices),
+    /// threads the number of cores rendering the voices (1 to kMaxThreads),
+    /// direct renders in the jack callback instead of the ring buffer filled by process(),
+    /// jack_midi reads midi from a jack port instead of RtMidi (implies direct)
+	OSCSynth(size_t voices = 7, size_t threads = 1, bool direct = true, bool jack_midi = false);
 	~OSCSynth();
 
 	// Setters
 	
- 	void lfoHandler();
-	void midiHandler();
-	void oscHandler();
+	void reportOverflows();
 	void presets(int preset);
 
-	void setAllSineAmpl(double val);
-	void setAllSawAmpl(double val);
-	void setAllSquareAmpl(double val);
-	void setAllNoiseAmpl(double val);
-	void setAllADSRStatus(int val);
-	void setAllADSRSustainLevel(double val);
-	void setAllADSRAttackTime(double val);
-	void setAllADSRReleaseTime(double val);
-	void setAllADSRDecayTime(double val);
-	void SetGain(double gain) { gain_ = gain; };
+	bool loadWaveform(const char *path);
+	void SetGain(double gain) { engine_->SetGain(gain); };
 	void process();
 
 };
\ No newline at end of file
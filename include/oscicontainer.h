@@ -2,12 +2,14 @@
 #define OSCICONTAINER_H
 
 #include <stdint.h>
+#include <stddef.h>
 #include <iostream>
 
 #include "sawtoothwave.h"
 #include "squarewave.h"
 #include "noise.h"
 #include "sinusoid.h"
+#include "wavetableosc.h"
 #include "releaseNote.h"
 #include "adsr.h"
 
@@ -18,6 +20,13 @@ private:
 	Sawtoothwave *osciSaw;
 	Squarewave *osciSquare;
 	Noise *osciNoise;
+
+	// band-limited stand-ins for sine, saw and square
+	WavetableOsc *wtSine;
+	WavetableOsc *wtSaw;
+	WavetableOsc *wtSquare;
+	// are the wavetables used instead of the naive generators
+	bool wavetableStatus;
 	
 	// lfo signal objects
 	Sawtoothwave *lfoSaw;
@@ -68,10 +77,14 @@ public:
 	void setADSRDecayTime(float t);
 	void setADSRSustainLevel(float level);
 	void setADSRReleaseTime(float t);
+	void setWavetableStatus(bool status);
 
 	// Getters
     double getNextSample();
     double getCurrentAmpl();
+
+    // Block rendering
+    void renderBlock(float *out, size_t n);
 };
 
 #endif // OSCICONTAINER_H
@@ -3,43 +3,67 @@
 
 #include <lo/lo.h>
 #include <iostream>
-#include <vector>
+#include <atomic>
+#include <stdint.h>
 
-#include "datatypes.h"
+#include "paramregistry.h"
+#include "spscqueue.h"
+#include "synthcommand.h"
 
 class OscMan {
 private:
     // An object representing a thread containing an OSC server
     lo_server_thread st;
 
-    // for each OSC message we store its path, value and type
-    std::vector<double> messages;
-    std::vector<std::string> paths;
-    std::vector<std::string> types;
+    // resolves the OSC addresses to parameter ids
+    const ParamRegistry *registry;
 
-    // stored value vectors
-    std::vector<dMess> dMessages;
-    std::vector<iMess> iMessages;
-    std::vector<sMess> sMessages;
+    // one slot per parameter, a message overwrites the value of its parameter
+    // (last value wins) and marks it in the dirty mask, the OSC server thread is the only writer
+    std::atomic<uint64_t> slotValue[PARAM_COUNT];     // bits of the double value
+    std::atomic<uint64_t> dirtyMask;                  // bit n set: parameter n has a new value
 
-    // callback function wich is processed every main loop cycle
+    // "/ModRoute source param depth" messages, every one adds a route, so none is overwritten,
+    // param is the OSC address or the id of the parameter
+    SpscQueue<synthCommand> routes;
+
+    // received messages and messages with an unknown path
+    std::atomic<size_t> messages;
+    std::atomic<size_t> unknownPaths;
+
+    // callback function, which runs in the OSC server thread for every message
     static int double_callback(const char *path, const char *types, lo_arg ** argv,
                             int argc, lo_message data, void *user_data);
 
+    // handles a "/ModRoute" message, called by double_callback
+    static int route_callback(OscMan *osc, const char *types, lo_arg **argv, int argc);
+
     void init(const char* port);
 
 public:
-    // Constructor
-    OscMan();
-    OscMan(const char* port);
+    // Number of route messages, which can wait for the rendering thread
+    static const size_t kRouteQueueSize = 64;
+
+    // Constructor, the registry has to be built and has to outlive the OscMan
+    OscMan(const ParamRegistry *registry);
+    OscMan(const char* port, const ParamRegistry *registry);
+    // Destructor, stops the OSC server thread
     ~OscMan();
 
+    // Takes all parameters, which have changed since the last call, one command each
+    // with its latest value. A preset comes first, so single parameters sent
+    // along with it win. cmds needs space for PARAM_COUNT commands, returns the number.
+    // Wait-free, call it from one thread only.
+    size_t drainCommands(synthCommand *cmds);
+
+    // Takes up to max CMD_MOD_ROUTE commands in the order of their messages, returns the number.
+    // Wait-free, call it from one thread only.
+    size_t drainRoutes(synthCommand *cmds, size_t max);
+
     // Getters
-    double getLastDouble();
-    double getLastInt();
-    double getLastChar();
-    std::string getLastPath();
-    std::string getLastType();
+    size_t getMessages() { return messages.load(std::memory_order_relaxed); }
+    size_t getUnknownPaths() { return unknownPaths.load(std::memory_order_relaxed); }
+    size_t getRouteOverflows() { return routes.GetOverflows(); }
 
 };
 
@@ -0,0 +1,211 @@
+/**
+ * @file oversampler.h
+ * @brief Oversampler class runs a nonlinearity at 2, 4 or 8 times the sample rate.
+ */
+
+//  The rate is raised and lowered in steps of two, each step is a half-band FIR filter in
+//  polyphase form: every other coefficient of a half-band filter is zero and the center one
+//  is 0.5, so when upsampling, one of the two output phases is a plain delay of the input and
+//  only the other phase needs a dot product, and when downsampling, the odd input samples are
+//  only delayed. A step therefore costs one dot product per base rate sample of the step.
+//  The dot products run in FirKernel, over a whole block with SIMD.
+//  The filters are Kaiser windowed sinc (beta 8). The first step, whose transition band lies
+//  closest to the audio band, has the longest filter, its length is set in the constructor;
+//  the later steps only have to suppress images far above it and get 5/8 and 1/2 of it.
+//  A longer filter has a narrower transition band and costs more and adds latency: a step with
+//  M half taps delays by 2 M - 1 samples of its lower rate, up and down together, see
+//  \ref Oversampler::GetLatency.
+//  All buffers are allocated for kMaxFactor and a maximum block in the constructor, so the
+//  factor can be switched while rendering. Any nonlinear stage can be oversampled with
+//  \ref Oversampler::Process, which splits a block of any length into chunks of the maximum
+//  block.
+
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+/**
+ * @brief One factor two step of the Oversampler, upsampling and downsampling filter.
+ */
+class HalfbandStage
+{
+public:
+    // CONSTRUCTOR
+    /**
+     * @brief Constructor with parameters.
+     * @param half_taps Number of nonzero coefficients besides the center one, divided by 2.
+     *        The filter has 4 * half_taps - 1 coefficients.
+     * @param max_block Maximum number of input samples of \ref Up, output samples of \ref Down.
+     */
+    HalfbandStage(size_t half_taps, size_t max_block);
+
+    // DESCTRUCTOR
+    /**
+     * @brief Standard Destructor.
+     */
+    ~HalfbandStage();
+
+    /**
+     * @brief Double the rate of a block.
+     * @param in Pointer to n input samples.
+     * @param out Pointer to 2 n output samples.
+     * @param n Number of input samples, at most max_block.
+     * @return Return void.
+     */
+    void Up(const float *in, float *out, size_t n);
+
+    /**
+     * @brief Halve the rate of a block.
+     * @param in Pointer to 2 n input samples.
+     * @param out Pointer to n output samples.
+     * @param n Number of output samples, at most max_block.
+     * @return Return void.
+     */
+    void Down(const float *in, float *out, size_t n);
+
+    /**
+     * @brief Clear the history of both filters.
+     * @return Return void.
+     */
+    void Reset();
+
+    // GETTER
+    /**
+     * @brief Get the number of nonzero side coefficients divided by 2.
+     * @return Return the half taps as a size_t.
+     */
+    size_t GetHalfTaps()    { return half_taps_; };
+
+    /**
+     * @brief Get the delay of \ref Up followed by \ref Down.
+     * @return Return the delay in samples of the lower rate as a size_t.
+     */
+    size_t GetLatency()     { return 2 * half_taps_ - 1; };
+
+private:
+    size_t              half_taps_;     /**< Half of the number of nonzero side coefficients. */
+    std::vector<float>  coeffs_;        /**< Nonzero side coefficients, symmetric. */
+    std::vector<float>  up_buf_;        /**< History and block of the upsampler input. */
+    std::vector<float>  even_buf_;      /**< History and block of the even downsampler inputs. */
+    std::vector<float>  odd_buf_;       /**< History and block of the odd downsampler inputs. */
+    std::vector<float>  acc_;           /**< Filtered phase of the upsampler. */
+};
+
+class Oversampler
+{
+public:
+    static const size_t kMaxFactor = 8;         /**< Highest oversampling factor. */
+    static const size_t kMaxStages = 3;         /**< Factor two steps of kMaxFactor. */
+    static const size_t kDefaultHalfTaps = 8;   /**< Half taps of the first step, 31 taps. */
+    static const size_t kMinHalfTaps = 2;       /**< Shortest filter of any step, 7 taps. */
+
+    // CONSTRUCTOR
+    /**
+     * @brief Constructor with parameters, the factor is 1.
+     * @param max_block Maximum number of base rate samples of a block.
+     * @param half_taps Half taps of the first step, the first step has 4 * half_taps - 1 taps.
+     */
+    Oversampler(size_t max_block, size_t half_taps = kDefaultHalfTaps);
+
+    // DESCTRUCTOR
+    /**
+     * @brief Standard Destructor.
+     */
+    ~Oversampler();
+
+    /**
+     * @brief Raise the rate of a block by the factor.
+     * @param in Pointer to n base rate samples.
+     * @param n Number of samples, at most max_block.
+     * @return Return a pointer to the n * factor samples at the high rate, valid until the next call.
+     */
+    float *Up(const float *in, size_t n);
+
+    /**
+     * @brief Lower the rate of a block, which \ref Up returned and which was processed in place.
+     * @param out Pointer to the n base rate output samples.
+     * @param n Number of base rate samples, the same as in \ref Up.
+     * @return Return void.
+     */
+    void Down(float *out, size_t n);
+
+    /**
+     * @brief Run a stage at the high rate on a block in place, in chunks of the maximum block.
+     * @param io Pointer to the n base rate samples.
+     * @param n Number of samples, any number.
+     * @param stage Function object stage(float *x, size_t m), which processes m high rate
+     *        samples in place.
+     * @return Return void.
+     */
+    template <typename F>
+    void Process(float *io, size_t n, F stage);
+
+    /**
+     * @brief Clear the history of all filters.
+     * @return Return void.
+     */
+    void Reset();
+
+    // SETTER
+    /**
+     * @brief Set the oversampling factor, the filters start from silence.
+     * @param factor 1, 2, 4 or 8, other values are rounded down to one of them.
+     * @return Return void.
+     */
+    void SetFactor(size_t factor);
+
+    // GETTER
+    /**
+     * @brief Get the oversampling factor.
+     * @return Return the factor as a size_t.
+     */
+    size_t GetFactor()      { return (size_t)1 << stages_; };
+
+    /**
+     * @brief Get the delay of \ref Up followed by \ref Down at the current factor.
+     * @return Return the delay in base rate samples as a double, 0 at factor 1.
+     */
+    double GetLatency();
+
+    /**
+     * @brief Get the half taps of the first step.
+     * @return Return the half taps as a size_t.
+     */
+    size_t GetHalfTaps()    { return stage_[0].GetHalfTaps(); };
+
+    /**
+     * @brief Get the maximum block of \ref Up and \ref Down.
+     * @return Return the number of base rate samples as a size_t.
+     */
+    size_t GetMaxBlock()    { return max_block_; };
+
+private:
+    std::vector<HalfbandStage>  stage_;             /**< Steps, 0 is next to the base rate. */
+    std::vector<float>          buf_[kMaxStages];   /**< Output of every upsampling step. */
+    size_t                      stages_;            /**< Steps in use. */
+    size_t                      max_block_;         /**< Maximum number of base rate samples. */
+};
+
+/**
+ * @brief Implementation of the template function Process.
+ */
+template <typename F>
+void
+Oversampler::Process(float *io, size_t n, F stage)
+{
+    if (stages_ == 0)
+    {
+        stage(io, n);
+        return;
+    }
+
+    auto factor = GetFactor();
+    for (size_t done = 0; done < n; done += max_block_)
+    {
+        auto m = (n - done < max_block_) ? n - done : max_block_;
+        auto high = Up(io + done, m);
+        stage(high, m * factor);
+        Down(io + done, m);
+    }
+}
@@ -0,0 +1,96 @@
+/**
+ * @file paramregistry.h
+ * @brief ParamRegistry class maps the OSC addresses of the synthesizer parameters to ids and setters.
+ */
+
+//  All parameters are added once at startup, then \ref Build searches a seed for the string
+//  hash, so that every address lands in its own slot of a power of two sized table (a perfect
+//  hash). Looking up an address costs one hash over its characters and one string compare,
+//  which rejects unknown addresses, independent of the number of parameters.
+//  The lookup runs in the OSC server thread, the rendering thread only sees (id, value) pairs
+//  and calls the setter of the id.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class SynthEngine;
+
+/**
+ * @brief Setter of a parameter.
+ */
+typedef void (*paramSetter)(SynthEngine *synth, double value);
+
+class ParamRegistry
+{
+public:
+    // CONSTRUCTOR
+    /**
+     * @brief Standard Constructor, the registry is empty.
+     */
+    ParamRegistry();
+
+    // DESCTRUCTOR
+    /**
+     * @brief Standard Destructor.
+     */
+    ~ParamRegistry();
+
+    /**
+     * @brief Add a parameter, only before \ref Build.
+     * @param path OSC address, e.g. "/SineAmpl", the string has to outlive the registry.
+     * @param id Parameter id, see \ref synthParam.
+     * @param setter Function, which sets the parameter.
+     * @return Return void.
+     */
+    void Add(const char *path, int id, paramSetter setter);
+
+    /**
+     * @brief Build the hash table of all added addresses.
+     * @return Return void.
+     */
+    void Build();
+
+    /**
+     * @brief Find the parameter id of an OSC address.
+     * @param path OSC address.
+     * @return Return the id, or -1 if the address is unknown.
+     */
+    int  Find(const char *path) const;
+
+    /**
+     * @brief Call the setter of a parameter.
+     * @param synth Synthesizer, whose parameter is set.
+     * @param id Parameter id.
+     * @param value New value.
+     * @return Return void.
+     */
+    void Set(SynthEngine *synth, int id, double value) const;
+
+    // GETTER
+    /**
+     * @brief Get the OSC address of a parameter.
+     * @param id Parameter id.
+     * @return Return the address, or NULL if the id is unknown.
+     */
+    const char *GetPath(int id) const;
+
+private:
+    /**
+     * @brief FNV-1a hash of a string, mixed with a seed.
+     * @param path String.
+     * @param seed Seed.
+     * @return Return the hash.
+     */
+    static uint32_t hash(const char *path, uint32_t seed);
+
+    std::vector<const char *>   paths_;     /**< Address of each id, NULL for unused ids. */
+    std::vector<paramSetter>    setters_;   /**< Setter of each id. */
+    std::vector<int>            ids_;       /**< Ids in the order they were added. */
+
+    std::vector<int>    table_;             /**< Id in each hash slot, -1 if empty. */
+    uint32_t            mask_;              /**< Table size - 1. */
+    uint32_t            seed_;              /**< Seed, for which no two addresses collide. */
+};
@@ -0,0 +1,30 @@
+/**
+ * @file polyblep.h
+ * @brief Polynomial band-limited step (PolyBLEP) correction for waveforms with jumps.
+ */
+
+//  A naive sawtooth or square jumps within one sample, which aliases. PolyBLEP replaces the
+//  sample before and after every jump by a 2nd order polynomial approximation of a band-limited
+//  step. The correction is written with min() instead of branches, so block loops over it can be
+//  vectorized by the compiler.
+
+#pragma once
+
+/**
+ * @brief Residual between a band-limited and a naive step of height 2, which jumps up at t = 0.
+ *        Add it to a naive waveform at every upward jump (subtract it at downward jumps).
+ * @param t Phase in periods, range from 0 to 1, the jump is at 0 (and 1).
+ * @param dt Phase increment per sample in periods, range from 0 to 0.5.
+ * @return Return the correction as a float, 0 if t is more than one sample away from the jump.
+ */
+inline float
+polyblep_residual(float t, float dt)
+{
+    // distance to the jump in samples after (a) and before (b) it, limited to one sample
+    float a = t / dt;
+    float b = (1.0f - t) / dt;
+    a = (a < 1.0f) ? a : 1.0f;
+    b = (b < 1.0f) ? b : 1.0f;
+
+    return (1.0f - b) * (1.0f - b) - (1.0f - a) * (1.0f - a);
+}
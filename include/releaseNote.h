@@ -1,6 +1,8 @@
 #ifndef releaseNote_h
 #define releaseNote_h
 
+#include <stddef.h>
+
 class releaseNote {
 private:
     // state of the releaseNote envelope, e.g. note_on, note_off ...
@@ -13,6 +15,7 @@ public:
 	releaseNote(void);
 
 	float process(void);
+	void processBlock(float *io, size_t n);
 	void gate(int on);
     void reset(void);
 
@@ -56,4 +59,13 @@ inline float releaseNote::process() {
     return output;
 }
 
+/* processBlock() function
+ * multiplies n samples of io with the envelope
+ */
+inline void releaseNote::processBlock(float *io, size_t n) {
+
+    for (size_t i = 0; i < n; i++)
+        io[i] *= process();
+}
+
 #endif
\ No newline at end of file
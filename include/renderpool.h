@@ -0,0 +1,104 @@
+/**
+ * @file renderpool.h
+ * @brief RenderPool class renders the active voices of a VoiceBank on several cpu cores.
+ */
+
+//  The pool owns threads - 1 worker threads, the calling thread is the first renderer.
+//  Every block the active set of the bank is split into contiguous parts. Each worker renders
+//  its part into its own bus, the calling thread renders the first part directly into the
+//  output, waits for the workers and sums their buses (fork/join).
+//  Start and completion are signalled with two atomic counters. A waiting thread spins for a
+//  short while and then sleeps on the counter with a futex, so there is no mutex on the audio
+//  path and an idle pool does not burn the cores. Workers are pinned to one core each and run
+//  with SCHED_FIFO, if the process is allowed to (see /etc/security/limits.conf).
+//  A part is only forked off for at least kMinVoices voices, below that one thread is faster.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "voicebank.h"
+
+class RenderPool
+{
+public:
+    static const size_t kMinVoices = 4;         /**< Minimum number of voices per part. */
+
+    // CONSTRUCTOR
+    /**
+     * @brief Constructor with parameters, starts the worker threads.
+     * @param bank Voice bank, whose active voices are rendered.
+     * @param threads Number of rendering threads including the calling thread, at least 1.
+     * @param max_frames Maximum block size, i.e. size of the worker buses.
+     * @param priority SCHED_FIFO priority of the workers, 0 keeps the normal scheduling.
+     */
+    RenderPool(VoiceBank *bank, size_t threads, size_t max_frames, int priority);
+
+    // DESCTRUCTOR
+    /**
+     * @brief Standard Destructor, stops and joins the worker threads.
+     */
+    ~RenderPool();
+
+    /**
+     * @brief Render the next n samples of all active voices and write their sum to out, like
+     *        \ref VoiceBank::RenderBlock. Must always be called from the same thread.
+     * @param out Pointer to the output samples.
+     * @param n Number of samples.
+     * @return Return void.
+     */
+    void RenderBlock(float *out, size_t n);
+
+    // GETTER
+    /**
+     * @brief Get the number of rendering threads including the calling thread.
+     * @return Return the number of threads as a size_t.
+     */
+    size_t  GetThreads()    { return workers_.size() + 1; };
+
+private:
+    /**
+     * @brief Render one block of at most max_frames_ samples.
+     * @param out Pointer to the output samples.
+     * @param n Number of samples.
+     * @return Return void.
+     */
+    void render(float *out, size_t n);
+
+    /**
+     * @brief Main loop of a worker thread.
+     * @param w Index of the worker, it renders part w + 1.
+     * @return Return void.
+     */
+    void worker(size_t w);
+
+    /**
+     * @brief Pin a worker to a core and raise its priority.
+     * @param w Index of the worker.
+     * @param priority SCHED_FIFO priority, 0 keeps the normal scheduling.
+     * @return Return void.
+     */
+    void setup_thread(size_t w, int priority);
+
+    VoiceBank   *bank_;                         /**< Voice bank of the voices. */
+    size_t      max_frames_;                    /**< Size of the worker buses. */
+
+    std::vector<std::thread>        workers_;   /**< Worker threads. */
+    std::vector<std::vector<float>> bus_;       /**< Output of every worker. */
+    std::vector<voiceScratch>       scratch_;   /**< Scratch buffers of every thread, 0 is the caller. */
+
+    std::atomic<uint32_t>   start_;             /**< Block counter, incremented to start the workers. */
+    std::atomic<uint32_t>   pending_;           /**< Number of workers, which have not finished the block. */
+    std::atomic<uint32_t>   start_sleepers_;    /**< Number of workers sleeping on start_. */
+    std::atomic<uint32_t>   pending_sleepers_;  /**< 1 while the calling thread sleeps on pending_. */
+    std::atomic<bool>       quit_;              /**< Stops the workers. */
+
+    // job of the current block, written before start_ is incremented
+    size_t  frames_;                            /**< Number of samples. */
+    size_t  active_;                            /**< Number of active voices. */
+    size_t  parts_;                             /**< Number of parts, the active voices are split into. */
+};
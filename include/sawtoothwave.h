@@ -6,6 +6,7 @@
 #define SAWTOOTHWAVE_H
 
 #include <cmath>
+#include <stddef.h>
 
 #define _USE_MATH_DEFINES
 
@@ -17,6 +18,7 @@ private:
     double amp;
     double phi;
     double curr_ampl;
+    bool blepOn;
 
 
     // SYSTEM RELATED
@@ -40,11 +42,17 @@ public:
     void frequency(double f);
     void amplitude(double a);
     void phase(double p);
+    /// PolyBLEP anti-aliasing on / off
+    void polyblep(bool on);
+    bool polyblep();
 
 
     double getNextSample();
     double getCurrentAmpl();
 
+    /// render the next n samples into out
+    void renderBlock(float *out, size_t n);
+
 };
 
 #endif // SQUAREWAVE_H
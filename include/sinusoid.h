@@ -6,6 +6,7 @@
 #define SINUSOID_H
 
 #include <math.h>
+#include <stddef.h>
 
 #define _USE_MATH_DEFINES
 
@@ -27,6 +28,9 @@ public:
     double getNextSample();
     double getCurrentAmpl();
 
+    /// render the next n samples into out
+    void renderBlock(float *out, size_t n);
+
 
 
 private:
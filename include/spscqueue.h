@@ -0,0 +1,101 @@
+/**
+ * @file spscqueue.h
+ * @brief SpscQueue class is a fixed size, wait-free queue from one producer to one consumer thread.
+ */
+
+//  The items live in a preallocated ring, the producer only writes head_ and the consumer only
+//  writes tail_, so Push and Pop never block, never allocate and finish in a constant number
+//  of steps. The two indices are kept on separate cache lines, so the threads do not slow
+//  each other down. Items should be small plain data, they are copied in and out.
+//  A push to a full queue drops the item and counts it, the count can be read by any thread.
+
+#pragma once
+
+#include <stddef.h>
+#include <atomic>
+#include <vector>
+
+template <typename T>
+class SpscQueue
+{
+public:
+    // CONSTRUCTOR
+    /**
+     * @brief Constructor with parameters, allocates the ring.
+     * @param capacity Number of items, rounded up to a power of two.
+     */
+    SpscQueue(size_t capacity)
+        : head_(0), overflows_(0), tail_(0)
+    {
+        size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+
+        items_.resize(size);
+        mask_ = size - 1;
+    }
+
+    // DESCTRUCTOR
+    /**
+     * @brief Standard Destructor.
+     */
+    ~SpscQueue() {}
+
+    /**
+     * @brief Append an item, only called by the producer thread.
+     * @param item Item to copy into the queue.
+     * @return Return false if the queue is full, the item is dropped then.
+     */
+    bool Push(const T &item)
+    {
+        auto head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) > mask_)
+        {
+            overflows_.store(overflows_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        items_[head & mask_] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Take the oldest item, only called by the consumer thread.
+     * @param item Returns the item.
+     * @return Return false if the queue is empty.
+     */
+    bool Pop(T &item)
+    {
+        auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire))
+            return false;
+
+        item = items_[tail & mask_];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // GETTER
+    /**
+     * @brief Get the number of items the queue can hold.
+     * @return Return the capacity as a size_t.
+     */
+    size_t  GetCapacity()   { return mask_ + 1; };
+
+    /**
+     * @brief Get the number of items, which were dropped because the queue was full.
+     * @return Return the number of dropped items as a size_t.
+     */
+    size_t  GetOverflows()  { return overflows_.load(std::memory_order_relaxed); };
+
+private:
+    std::vector<T>      items_;                 /**< Ring of items. */
+    size_t              mask_;                  /**< Capacity - 1, wraps the indices. */
+
+    char                pad0_[64];              /**< Keeps head_ off the cache line of the ring pointers. */
+    std::atomic<size_t> head_;                  /**< Index of the next item to write, written by the producer. */
+    std::atomic<size_t> overflows_;             /**< Number of dropped items, written by the producer. */
+    char                pad1_[64];              /**< Keeps the producer and the consumer side on separate cache lines. */
+    std::atomic<size_t> tail_;                  /**< Index of the next item to read, written by the consumer. */
+};
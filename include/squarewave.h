@@ -6,6 +6,7 @@
 #define SQUAREWAVE_H
 
 #include <math.h>
+#include <stddef.h>
 
 #define _USE_MATH_DEFINES
 
@@ -22,11 +23,17 @@ public:
     void frequency(double f);
     void amplitude(double a);
     void phase(double p);
+    /// PolyBLEP anti-aliasing on / off
+    void polyblep(bool on);
+    bool polyblep();
 
 
     double getNextSample();
     double getCurrentAmpl();
 
+    /// render the next n samples into out
+    void renderBlock(float *out, size_t n);
+
 
 
 private:
@@ -36,6 +43,7 @@ private:
     double amp;
     double phi;
     double curr_ampl;
+    bool blepOn;
 
     // SYSTEM RELATED
     int nframes;
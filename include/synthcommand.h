@@ -0,0 +1,66 @@
+/**
+ * @file synthcommand.h
+ * @brief Control events, which are passed from the control threads to the audio rendering.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Types of control events.
+ */
+enum commandType
+{
+    CMD_NOTE_ON = 0,            /**< Start a note, id is the midi note, value the velocity (0 to 1). */
+    CMD_NOTE_OFF = 1,           /**< Release a note, id is the midi note. */
+    CMD_PARAM = 2,              /**< Set a parameter, id is a \ref synthParam. */
+    CMD_CONTROL = 3,            /**< Midi control change, id is the controller, value its value (0 to 1). */
+    CMD_MOD_ROUTE = 4           /**< Add a modulation route, id is source * PARAM_COUNT + parameter, value the depth. */
+};
+
+/**
+ * @brief Parameters, which can be set with a CMD_PARAM event. The OSC address and the setter
+ *        of every id are registered in SynthEngine::register_params.
+ */
+enum synthParam
+{
+    PARAM_SINE_AMPL = 0,        /**< /SineAmpl */
+    PARAM_SAW_AMPL,             /**< /SawAmpl */
+    PARAM_SQUARE_AMPL,          /**< /SquareAmpl */
+    PARAM_NOISE_AMPL,           /**< /NoiseAmpl */
+    PARAM_WAVE_AMPL,            /**< /WaveAmpl */
+    PARAM_WAVETABLE,            /**< /Wavetable */
+    PARAM_POLYBLEP,             /**< /PolyBLEP */
+    PARAM_FILTER_Q,             /**< /LFO_Q */
+    PARAM_FILTER_TYPE,          /**< /Filter_Type */
+    PARAM_FILTER_GAIN,          /**< /Filter_Gain */
+    PARAM_FILTER_STATUS,        /**< /Filter_Status */
+    PARAM_FILTER_CUTOFF,        /**< /Filter_Cutoff */
+    PARAM_LFO_FREQ,             /**< /LFO_Freq */
+    PARAM_LFO_TYPE,             /**< /LFO_Type */
+    PARAM_GAIN,                 /**< /Gain */
+    PARAM_DISTORTION_DRIVE,     /**< /Distortion_Drive */
+    PARAM_DISTORTION_RANGE,     /**< /Distortion_Range */
+    PARAM_DISTORTION_BLEND,     /**< /Distortion_Blend */
+    PARAM_DISTORTION_OVERSAMPLING, /**< /Distortion_Oversampling */
+    PARAM_DISTORTION_MODEL,     /**< /Distortion_Model */
+    PARAM_DISTORTION_STATUS,    /**< /Distortion_Status */
+    PARAM_ADSR_STATUS,          /**< /ADSR_Status */
+    PARAM_ADSR_SUSTAIN,         /**< /ADSR_Sustain_Level */
+    PARAM_ADSR_ATTACK,          /**< /ADSR_Attack_Time */
+    PARAM_ADSR_RELEASE,         /**< /ADSR_Release_Time */
+    PARAM_ADSR_DECAY,           /**< /ADSR_Decay_Time */
+    PARAM_PRESET,               /**< /Preset */
+    PARAM_COUNT                 /**< Number of parameters. */
+};
+
+/**
+ * @brief Control event, plain data, so it can be copied through a lock-free queue.
+ */
+struct synthCommand
+{
+    int32_t type;               /**< Event type, see \ref commandType. */
+    int32_t id;                 /**< Midi note, \ref synthParam or route. */
+    double  value;              /**< Velocity, parameter value or depth. */
+};
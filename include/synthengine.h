@@ -0,0 +1,313 @@
+/**
+ * @file synthengine.h
+ * @brief SynthEngine class renders the synthesizer, voices, modulation and effects, without any
+ *        audio or control interface.
+ */
+
+//  The engine owns everything that produces sound: the voice bank and its allocator, the
+//  optional render pool, the modulation matrix with the lfo, the filter and the distortion, and
+//  the registry of the parameters. It knows nothing about JACK, OSC or midi ports; a front end
+//  schedules control events (\ref synthCommand) at their frame in the next block and calls
+//  \ref Render. OSCSynth is the realtime front end, which feeds it from JACK, RtMidi and liblo;
+//  oscsynth-render feeds it from a midi file and renders faster than real time.
+//  Render, Schedule and the setters are called from one thread only, the rendering thread.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "Biquad.h"
+#include "distortion.h"
+#include "eventscheduler.h"
+#include "modmatrix.h"
+#include "oscicontainer.h"
+#include "paramregistry.h"
+#include "renderpool.h"
+#include "synthcommand.h"
+#include "voiceallocator.h"
+#include "voicebank.h"
+
+//Preset Numbers
+enum presetnumber{
+    wobble = 		1,
+    dreamy = 		2,
+    nice_pulse=		3,
+    in_the_night=	4,
+    high_hat=		5,
+};
+
+class SynthEngine
+{
+public:
+    static const size_t kMaxVoices = 256;       /**< Maximum polyphony. */
+    static const size_t kMaxThreads = 64;       /**< Maximum number of rendering threads. */
+    static const int kRenderPriority = 60;      /**< SCHED_FIFO priority of the render threads. */
+    static const size_t kControlBlock = 32;     /**< Samples between two evaluations of the modulation matrix. */
+
+    // The sum of the voices is scaled with a fixed 1/7, the level of the former seven voice
+    // synthesizer, whatever the polyphony, so a note is as loud at -v 256 as at -v 7. A full
+    // scale voice peaks at -16.9 dB, seven in phase reach 0 dB; larger chords, with the
+    // polyphony to play them, need a /Gain below 1 (about 1/sqrt(voices / 7) for uncorrelated
+    // voices) to keep the headroom.
+    static constexpr double kMixGain = 1.0 / 7.0;   /**< Gain of the sum of all voices. */
+
+    // CONSTRUCTOR
+    /**
+     * @brief Constructor with parameters.
+     * @param fs Sample rate in Hz.
+     * @param max_block Maximum number of samples of \ref Render.
+     * @param voices Polyphony, limited to 1 to kMaxVoices.
+     * @param threads Cores rendering the voices, limited to 1 to kMaxThreads.
+     */
+    SynthEngine(uint32_t fs, size_t max_block, size_t voices = 7, size_t threads = 1);
+
+    // DESCTRUCTOR
+    /**
+     * @brief Standard Destructor.
+     */
+    ~SynthEngine();
+
+    /**
+     * @brief Schedule a control event in the next block. An event after its last sample is
+     *        applied at the start of the block after it.
+     * @param frame Position in samples from the start of the next block, 0 to below max_block.
+     * @param cmd Event.
+     * @return Return false if the block has no space for more events or the frame is out of
+     *         range, the event is dropped then.
+     */
+    bool Schedule(double frame, const synthCommand &cmd);
+
+    /**
+     * @brief Render a block, the scheduled events are applied at their frame and removed, the
+     *        events after its last sample stay scheduled for the next block.
+     * @param out Pointer to the n output samples.
+     * @param n Number of samples, at most max_block.
+     * @return Return void.
+     */
+    void Render(float *out, size_t n);
+
+    /**
+     * @brief Turn a midi message into a note or control command.
+     * @param status Status byte.
+     * @param data1 First data byte.
+     * @param data2 Second data byte.
+     * @param cmd Command.
+     * @return Return false if the message has no command.
+     */
+    static bool MidiToCommand(uint8_t status, uint8_t data1, uint8_t data2, synthCommand &cmd);
+
+    /**
+     * @brief Add a route from a modSource to a synthParam, not while rendering, a CMD_MOD_ROUTE
+     *        event adds it from the rendering thread instead.
+     * @param source Source, see \ref modSource.
+     * @param param Parameter, see \ref synthParam.
+     * @param depth Depth in the units of the parameter.
+     * @return Return false if the route is invalid.
+     */
+    bool AddModRoute(int source, int param, double depth);
+
+    /**
+     * @brief Load a single cycle wav file as user waveform, see "/WaveAmpl".
+     * @param path Path of the file.
+     * @return Return true on success.
+     */
+    bool LoadWaveform(const char *path);
+
+    // SETTER
+    /**
+     * @brief Set all parameters of a preset.
+     * @param preset Preset, see \ref presetnumber.
+     * @return Return void.
+     */
+    void SetPreset(int preset);
+
+    /**
+     * @brief Set the sine amplitude of all voices.
+     * @param val Amplitude, 0 to 1.
+     * @return Return void.
+     */
+    void SetAllSineAmpl(double val);
+
+    /**
+     * @brief Set the sawtooth amplitude of all voices.
+     * @param val Amplitude, 0 to 1.
+     * @return Return void.
+     */
+    void SetAllSawAmpl(double val);
+
+    /**
+     * @brief Set the square amplitude of all voices.
+     * @param val Amplitude, 0 to 1.
+     * @return Return void.
+     */
+    void SetAllSquareAmpl(double val);
+
+    /**
+     * @brief Set the noise amplitude of all voices, halved.
+     * @param val Amplitude, 0 to 1.
+     * @return Return void.
+     */
+    void SetAllNoiseAmpl(double val);
+
+    /**
+     * @brief Set the amplitude of the user waveform of all voices.
+     * @param val Amplitude, 0 to 1.
+     * @return Return void.
+     */
+    void SetAllWaveAmpl(double val);
+
+    /**
+     * @brief Switch all voices to the band-limited wavetables.
+     * @param val 1 on, anything else off.
+     * @return Return void.
+     */
+    void SetAllWavetable(int val);
+
+    /**
+     * @brief Switch the naive saw and square of all voices to PolyBLEP anti-aliasing.
+     * @param val 1 on, anything else off.
+     * @return Return void.
+     */
+    void SetAllPolyBLEP(int val);
+
+    /**
+     * @brief Switch the envelope of all voices.
+     * @param val 1 on, anything else off.
+     * @return Return void.
+     */
+    void SetAllADSRStatus(int val);
+
+    /**
+     * @brief Set the sustain level of all voices.
+     * @param val Sustain level in percent.
+     * @return Return void.
+     */
+    void SetAllADSRSustainLevel(double val);
+
+    /**
+     * @brief Set the attack time of all voices.
+     * @param val Attack time.
+     * @return Return void.
+     */
+    void SetAllADSRAttackTime(double val);
+
+    /**
+     * @brief Set the release time of all voices.
+     * @param val Release time.
+     * @return Return void.
+     */
+    void SetAllADSRReleaseTime(double val);
+
+    /**
+     * @brief Set the decay time of all voices.
+     * @param val Decay time.
+     * @return Return void.
+     */
+    void SetAllADSRDecayTime(double val);
+
+    /**
+     * @brief Set the output gain.
+     * @param gain Gain as a double.
+     * @return Return void.
+     */
+    void SetGain(double gain)               { gain_ = gain; };
+
+    // GETTER
+    /**
+     * @brief Get the registry of the parameters, e.g. to resolve OSC addresses.
+     * @return Return the registry.
+     */
+    const ParamRegistry &GetParams()        { return params_; };
+
+    /**
+     * @brief Get the number of events, which can still be scheduled in the next block.
+     * @return Return the number as a size_t.
+     */
+    size_t GetFreeEvents()                  { return scheduler_.GetFree(); };
+
+    /**
+     * @brief Get the polyphony.
+     * @return Return the number of voices as a size_t.
+     */
+    size_t GetVoices()                      { return voices_->GetSize(); };
+
+    /**
+     * @brief Get the sample rate.
+     * @return Return the sample rate in Hz as a uint32_t.
+     */
+    uint32_t GetSampleRate()                { return fs_; };
+
+    /**
+     * @brief Get the maximum block of \ref Render.
+     * @return Return the number of samples as a size_t.
+     */
+    size_t GetMaxBlock()                    { return max_block_; };
+
+private:
+    /**
+     * @brief Render the next n samples of all voices, without the effects, and the cutoff ramp
+     *        of the filter for them.
+     * @param out Pointer to the output samples.
+     * @param cutoff Pointer to the cutoff of every sample.
+     * @param n Number of samples.
+     * @return Return void.
+     */
+    void render_voices(float *out, float *cutoff, size_t n);
+
+    /**
+     * @brief Evaluate the modulation matrix and set the modulated parameters.
+     * @return Return void.
+     */
+    void modulate();
+
+    /**
+     * @brief Add all parameters to params_, the only place which knows the OSC addresses.
+     * @return Return void.
+     */
+    void register_params();
+
+    /**
+     * @brief Apply one control event.
+     * @param cmd Event.
+     * @param offset Time in samples, by which the event lies before the next rendered sample.
+     * @return Return void.
+     */
+    void apply_command(const synthCommand &cmd, double offset = 0.0);
+
+    /**
+     * @brief Set a parameter and the base of its modulation.
+     * @param id Parameter, see \ref synthParam.
+     * @param value Value.
+     * @return Return void.
+     */
+    void set_param(int id, double value);
+
+    uint32_t        fs_;                /**< Sample rate in Hz. */
+    size_t          max_block_;         /**< Maximum number of samples of a block. */
+    double          gain_;              /**< Output gain. */
+
+    VoiceBank       *voices_;           /**< All playable notes. */
+    VoiceAllocator  *allocator_;        /**< Assigns the notes to the voices. */
+    RenderPool      *pool_;             /**< NULL if the voices are rendered by the calling thread only. */
+    ParamRegistry   params_;            /**< OSC address, id and setter of every parameter. */
+    EventScheduler  scheduler_;         /**< Control events of the next block, ordered by frame. */
+
+    Biquad          *filter_;           /**< Filter of the sum of the voices. */
+    Oscicontainer   *lfo_;              /**< Modulation source. */
+    Distortion      *distortion_;       /**< Distortion after the filter. */
+    bool            filter_status_;     /**< Filter on. */
+    bool            distortion_status_; /**< Distortion on. */
+
+    // lfo, envelope, velocity and midi controllers modulate the parameters through the matrix,
+    // evaluated every kControlBlock samples
+    ModMatrix       mod_;               /**< Modulation matrix. */
+    size_t          control_left_;      /**< Samples until the next evaluation. */
+    int             last_voice_;        /**< Voice of the last note, source of the envelope, -1 before the first note. */
+    float           cutoff_;            /**< Cutoff of the filter, ramped per sample towards the modulated value. */
+    float           cutoff_step_;       /**< Ramp of the cutoff per sample. */
+
+    std::vector<float>  cutoff_block_;  /**< Cutoff of every sample of a block. */
+    std::vector<float>  lfo_block_;     /**< One control block of the lfo. */
+};
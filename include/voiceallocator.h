@@ -0,0 +1,123 @@
+/**
+ * @file voiceallocator.h
+ * @brief VoiceAllocator class assigns midi notes to the voices of a VoiceBank in constant time.
+ */
+
+//  Every voice is in exactly one of three intrusive, doubly linked lists, which are stored as
+//  index arrays: free, active (note held) and releasing (note released, envelope still audible).
+//  Active and releasing voices are appended at the tail, so each list is ordered by age.
+//  A table with one entry per midi note maps a note to its voice.
+//  A note-on takes a free voice; if there is none, it steals the quietest of the oldest
+//  kStealCandidates releasing voices, and only if no voice is releasing, the oldest active one.
+//  A releasing voice returns to the free list when its envelope has finished, see \ref Reclaim.
+//  Note-on and note-off cost the same for any number of voices.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "voicebank.h"
+
+/**
+ * @brief Lists of the voice allocator.
+ */
+enum voiceList
+{
+    LIST_FREE = 0,              /**< Voice is silent and can be used. */
+    LIST_ACTIVE = 1,            /**< Voice plays a held note. */
+    LIST_RELEASING = 2          /**< Voice plays the release of a note. */
+};
+
+class VoiceAllocator
+{
+public:
+    static const size_t kNotes = 128;           /**< Number of midi notes. */
+    static const size_t kStealCandidates = 4;   /**< Releasing voices compared when stealing. */
+
+    // CONSTRUCTOR
+    /**
+     * @brief Constructor with parameters, all voices are free.
+     * @param bank Voice bank, which is queried for the level and state of the voices.
+     */
+    VoiceAllocator(VoiceBank *bank);
+
+    // DESCTRUCTOR
+    /**
+     * @brief Standard Destructor.
+     */
+    ~VoiceAllocator();
+
+    /**
+     * @brief Assign a voice to a note. A voice which already plays the note is reused.
+     * @param note Midi note, 0 to 127.
+     * @return Return the voice index, or -1 if the note is out of range.
+     */
+    int NoteOn(int note);
+
+    /**
+     * @brief Move the voice of a note to the releasing list.
+     * @param note Midi note, 0 to 127.
+     * @return Return the voice index, or -1 if the note is not playing.
+     */
+    int NoteOff(int note);
+
+    /**
+     * @brief Return all releasing voices, whose envelope has finished, to the free list.
+     *        Call it once per rendered block.
+     * @return Return void.
+     */
+    void Reclaim();
+
+    // GETTER
+    /**
+     * @brief Get the number of voices in a list.
+     * @param list List, see \ref voiceList.
+     * @return Return the number of voices as a size_t.
+     */
+    size_t  GetCount(int list)      { return count_[list]; };
+
+    /**
+     * @brief Get the voice of a note.
+     * @param note Midi note, 0 to 127.
+     * @return Return the voice index, or -1 if the note is not held.
+     */
+    int     GetVoice(int note);
+
+private:
+    /**
+     * @brief Remove a voice from its list.
+     * @param voice Voice index.
+     * @return Return void.
+     */
+    void unlink(int voice);
+
+    /**
+     * @brief Append a voice to the tail of a list.
+     * @param voice Voice index.
+     * @param list List, see \ref voiceList.
+     * @return Return void.
+     */
+    void append(int voice, int list);
+
+    /**
+     * @brief Pick the voice for a new note: free, else quietest releasing, else oldest active.
+     * @return Return the voice index.
+     */
+    int steal();
+
+    VoiceBank   *bank_;                     /**< Voice bank of the voices. */
+
+    // per voice links, the index in each vector is the voice number
+    std::vector<int>    prev_;              /**< Previous voice in the list, -1 at the head. */
+    std::vector<int>    next_;              /**< Next voice in the list, -1 at the tail. */
+    std::vector<int>    list_;              /**< List of the voice. */
+    std::vector<int>    note_;              /**< Held note of the voice, -1 if none. */
+
+    int     head_[3];                       /**< Oldest voice of each list. */
+    int     tail_[3];                       /**< Newest voice of each list. */
+    size_t  count_[3];                      /**< Number of voices in each list. */
+
+    int16_t note_to_voice_[kNotes];         /**< Voice of each held note, -1 if none. */
+};
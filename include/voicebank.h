@@ -0,0 +1,317 @@
+/**
+ * @file voicebank.h
+ * @brief VoiceBank class holds all playable voices of the synthesizer in contiguous, parallel arrays.
+ */
+
+//  Every voice consists of a sine, sawtooth, square and noise generator, a releaseNote envelope
+//  and an ADSR envelope. Instead of one heap allocated Oscicontainer per voice, the bank keeps
+//  the state of all voices side by side (structure of arrays), so a render call walks the
+//  voices linearly without any map lookups or pointer chasing.
+//  The three periodic generators of a voice always share frequency and phase, so one phase
+//  and one phase increment per voice is enough. In wavetable mode the weighted sum of sine,
+//  sawtooth, square and a user waveform is one band-limited Wavetable, so a voice costs one
+//  table read per sample, whatever the mix. The setters only mark the table as outdated; it is
+//  rebuilt once before the next block, and only in wavetable mode, so neither a burst of OSC
+//  messages nor the modulation matrix, which writes the amplitudes every control block, rebuilds
+//  it more than once per block or at all while the naive generators are used.
+//  Only the voices in the active set are rendered. A voice joins the set on note-on and leaves
+//  it at the end of the first block in which its envelope reports note off, so idle voices cost
+//  nothing. Generators with an amplitude of zero are skipped as well.
+//  Every voice has its own noise generator, seeded from \ref SetNoiseSeed, so the noise of a
+//  voice does not depend on which thread renders it, and a seed reproduces a render.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include "adsr.h"
+#include "noisekernel.h"
+#include "releaseNote.h"
+#include "wavetable.h"
+
+/**
+ * @brief Scratch buffers of one rendering thread, see \ref VoiceBank::RenderActive.
+ */
+struct voiceScratch
+{
+    static const size_t kChunkSize = 64;    /**< Size of the buffers. */
+
+    float   phase[kChunkSize];              /**< Phase of every sample of the chunk. */
+    float   sine[kChunkSize];               /**< Sine of every sample of the chunk. */
+    float   voice[kChunkSize];              /**< Signal of one voice. */
+};
+
+class VoiceBank
+{
+public:
+    // CONSTRUCTOR
+    /**
+     * @brief Constructor with parameters.
+     * @param fs Sample rate in Hz.
+     * @param size Number of voices in the bank.
+     */
+    VoiceBank(uint32_t fs, size_t size);
+
+    // DESCTRUCTOR
+    /**
+     * @brief Standard Destructor.
+     */
+    ~VoiceBank();
+
+    /**
+     * @brief Start a note on a voice. Frequency and amplitude are set, the phase is reset
+     *        and both envelopes enter their attack state.
+     * @param voice Index of the voice.
+     * @param f Frequency in Hz.
+     * @param a Amplitude (velocity), range from 0.0 to 1.0.
+     * @param offset Time in samples, by which the note started before the next rendered
+     *        sample, range from 0.0 to 1.0. The phase starts advanced by it (fractional onset).
+     * @return Return void.
+     */
+    void NoteOn(size_t voice, double f, double a, double offset = 0.0);
+
+    /**
+     * @brief Let a voice enter its release state.
+     * @param voice Index of the voice.
+     * @return Return void.
+     */
+    void NoteOff(size_t voice);
+
+    /**
+     * @brief Render the next n samples of all voices and write their sum to out.
+     * @param out Pointer to the output samples.
+     * @param n Number of samples.
+     * @return Return void.
+     */
+    void RenderBlock(float *out, size_t n);
+
+    /**
+     * @brief Render the next n samples of a part of the active set and write their sum to out.
+     *        Disjoint parts may be rendered by several threads at once, each with its own
+     *        scratch buffers. The active set must not change until all parts are rendered,
+     *        then \ref RetireIdle is called once.
+     * @param first First slot of the active set.
+     * @param last Slot after the last one, at most \ref GetActiveCount.
+     * @param out Pointer to the output samples.
+     * @param n Number of samples.
+     * @param scratch Scratch buffers of the calling thread.
+     * @return Return void.
+     */
+    void RenderActive(size_t first, size_t last, float *out, size_t n, voiceScratch &scratch);
+
+    /**
+     * @brief Remove all voices, whose envelope has finished, from the active set.
+     * @return Return void.
+     */
+    void RetireIdle();
+
+    /**
+     * @brief Rebuild the mixed wavetable, if an amplitude or the user waveform changed and the
+     *        wavetable mode is on. Called once before the voices of a block are rendered, by
+     *        \ref RenderBlock or the thread, which splits the block over \ref RenderActive.
+     * @return Return void.
+     */
+    void UpdateWavetable();
+
+    // GETTER
+    /**
+     * @brief Get the number of voices.
+     * @return Return the number of voices as a size_t.
+     */
+    size_t  GetSize()       { return size_; };
+
+    /**
+     * @brief Get the number of voices in the active set, i.e. the voices which are rendered.
+     * @return Return the number of active voices as a size_t.
+     */
+    size_t  GetActiveCount()    { return active_count_; };
+
+    /**
+     * @brief Check if the envelope of a voice has finished, i.e. the voice is silent.
+     * @param voice Index of the voice.
+     * @return Return true if the voice is silent.
+     */
+    bool    IsIdle(size_t voice);
+
+    /**
+     * @brief Get the current level of a voice, i.e. its amplitude times its envelope.
+     * @param voice Index of the voice.
+     * @return Return the level as a float.
+     */
+    float   GetLevel(size_t voice);
+
+    // SETTER
+    /**
+     * @brief Set the sine amplitude of all voices.
+     * @param a Amplitude as a double.
+     * @return Return void.
+     */
+    void    SetSineAmpl(double a);
+
+    /**
+     * @brief Set the sawtooth amplitude of all voices.
+     * @param a Amplitude as a double.
+     * @return Return void.
+     */
+    void    SetSawAmpl(double a);
+
+    /**
+     * @brief Set the square amplitude of all voices.
+     * @param a Amplitude as a double.
+     * @return Return void.
+     */
+    void    SetSquareAmpl(double a);
+
+    /**
+     * @brief Set the noise amplitude of all voices.
+     * @param a Amplitude as a double.
+     * @return Return void.
+     */
+    void    SetNoiseAmpl(double a)      { noise_ampl_ = a; };
+
+    /**
+     * @brief Seed the noise generators, voice v gets the seed + v.
+     * @param seed Seed, the constructor uses 1.
+     * @return Return void.
+     */
+    void    SetNoiseSeed(uint32_t seed);
+
+    /**
+     * @brief Set the amplitude of the user waveform of all voices, only audible in wavetable mode.
+     * @param a Amplitude as a double.
+     * @return Return void.
+     */
+    void    SetWaveAmpl(double a);
+
+    /**
+     * @brief Load the user waveform from a wav file with one period, see \ref Wavetable::LoadFile.
+     * @param path Path of the wav file.
+     * @return Return true on success.
+     */
+    bool    LoadWaveform(const char *path);
+
+    /**
+     * @brief Set the wavetable mode of all voices. If it is off, the naive generators are used.
+     * @param status Wavetable status as a bool. True = on and False = off.
+     * @return Return void.
+     */
+    void    SetWavetable(bool status)   { wavetable_status_ = status; };
+
+    /**
+     * @brief Set the PolyBLEP anti-aliasing of the naive sawtooth and square of all voices.
+     * @param status PolyBLEP status as a bool. True = on and False = off.
+     * @return Return void.
+     */
+    void    SetPolyBLEP(bool status)    { polyblep_status_ = status; };
+
+    /**
+     * @brief Set the ADSR status of all voices. If the ADSR is off, the releaseNote envelope is used.
+     * @param status ADSR status as a bool. True = on and False = off.
+     * @return Return void.
+     */
+    void    SetADSRStatus(bool status)  { adsr_status_ = status; };
+
+    /**
+     * @brief Set the ADSR attack time of all voices.
+     * @param t Attack time, as a float, range from 1.0f to 99.0f.
+     * @return Return void.
+     */
+    void    SetADSRAttack(float t);
+
+    /**
+     * @brief Set the ADSR decay time of all voices.
+     * @param t Decay time, as a float, range from 1.0f to 99.0f.
+     * @return Return void.
+     */
+    void    SetADSRDecay(float t);
+
+    /**
+     * @brief Set the ADSR sustain level of all voices.
+     * @param level Sustain level, as a float, range from 1.0f to 99.0f.
+     * @return Return void.
+     */
+    void    SetADSRSustain(float level);
+
+    /**
+     * @brief Set the ADSR release time of all voices.
+     * @param t Release time, as a float, range from 1.0f to 99.0f.
+     * @return Return void.
+     */
+    void    SetADSRRelease(float t);
+
+private:
+    /**
+     * @brief Add a voice to the active set, if it is not in there yet.
+     * @param v Index of the voice.
+     * @return Return void.
+     */
+    void activate(size_t v);
+
+    /**
+     * @brief Remove a voice from the active set, the last active voice takes its slot.
+     * @param v Index of the voice.
+     * @return Return void.
+     */
+    void deactivate(size_t v);
+
+    /**
+     * @brief Render a chunk of at most voiceScratch::kChunkSize samples of one voice and add it to out.
+     * @param v Index of the voice.
+     * @param out Pointer to the output samples.
+     * @param n Number of samples.
+     * @param s Scratch buffers.
+     * @return Return void.
+     */
+    void render_voice(size_t v, float *out, size_t n, voiceScratch &s);
+
+    /**
+     * @brief Rebuild the mixed wavetable from the amplitudes of the waveforms.
+     * @return Return void.
+     */
+    void update_wavetable();
+
+    /**
+     * @brief Render the naive sine, sawtooth and square of the current chunk into s.voice.
+     * @param inc Phase increment per sample in radians.
+     * @param n Number of samples.
+     * @param s Scratch buffers, s.phase holds the phases.
+     * @return Return void.
+     */
+    void render_naive(double inc, size_t n, voiceScratch &s);
+
+    size_t  size_;                          /**< Number of voices. */
+    int     fs_;                            /**< Sample rate. */
+
+    // per voice state, the index in each vector is the voice number
+    std::vector<double>         phase_;     /**< Phase of the periodic generators, 0 to 2 pi. */
+    std::vector<double>         increment_; /**< Phase increment per sample. */
+    std::vector<double>         ampl_;      /**< Amplitude (velocity) of the voice. */
+    std::vector<ADSR>           envelope_;  /**< ADSR envelopes. */
+    std::vector<releaseNote>    rel_note_;  /**< releaseNote envelopes. */
+    std::vector<noiseState>     noise_;     /**< Noise generators. */
+    std::vector<int>            active_pos_;/**< Slot of the voice in active_, -1 if idle. */
+
+    // active set, the first active_count_ entries are the voices which are rendered
+    std::vector<int>    active_;            /**< Indices of the active voices. */
+    size_t              active_count_;      /**< Number of active voices. */
+
+    // state shared by all voices
+    double  sine_ampl_;                     /**< Sine amplitude. */
+    double  saw_ampl_;                      /**< Sawtooth amplitude. */
+    double  square_ampl_;                   /**< Square amplitude. */
+    double  noise_ampl_;                    /**< Noise amplitude. */
+    double  wave_ampl_;                     /**< User waveform amplitude. */
+    bool    adsr_status_;                   /**< If the ADSR or the releaseNote envelope is used. */
+    bool    wavetable_status_;              /**< If the mixed wavetable or the naive generators are used. */
+    bool    polyblep_status_;               /**< If the naive sawtooth and square are PolyBLEP corrected. */
+    bool    mix_dirty_;                     /**< If mix_table_ does not match the amplitudes. */
+    const Wavetable *sine_table_;           /**< Built-in sine, built by the constructor. */
+    const Wavetable *saw_table_;            /**< Built-in sawtooth, built by the constructor. */
+    const Wavetable *square_table_;         /**< Built-in square, built by the constructor. */
+    Wavetable   user_table_;                /**< User waveform. */
+    Wavetable   mix_table_;                 /**< Weighted sum of all waveforms. */
+
+    voiceScratch    scratch_;               /**< Scratch buffers of \ref RenderBlock. */
+};
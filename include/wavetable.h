@@ -0,0 +1,133 @@
+/**
+ * @file wavetable.h
+ * @brief Wavetable class holds one period of a waveform as a set of band-limited mip levels.
+ */
+
+//  Every mip level holds one period of the waveform with kTableSize samples, but only with the
+//  harmonics that stay below nyquist up to the highest frequency the level is used for. Level 0
+//  is used up to 2 * kTableSize^-1 * fs (about 47 Hz at 48 kHz) and every further level covers
+//  one octave more with half the harmonics, the last level is a pure sine.
+//  A table read interpolates linearly between two samples and crossfades between the two mip
+//  levels around the current frequency, so sweeps do not click when the level changes.
+//  The cost per sample is two interpolated reads, regardless of frequency and waveform.
+
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+/**
+ * @brief Built-in waveforms of the wavetable.
+ */
+enum waveShape
+{
+    SHAPE_SINE = 0,             /**< Sine. */
+    SHAPE_SAW = 1,              /**< Rising sawtooth from -1 to 1, like Sawtoothwave. */
+    SHAPE_SQUARE = 2            /**< Square, 1 for the first half period, like Squarewave. */
+};
+
+class Wavetable
+{
+public:
+    static const size_t kTableSize = 2048;      /**< Samples per period and mip level. */
+    static const size_t kLevels = 10;           /**< Number of mip levels. */
+
+    // CONSTRUCTOR
+    /**
+     * @brief Standard Constructor, the table is silent.
+     */
+    Wavetable();
+
+    /**
+     * @brief Constructor with a built-in waveform.
+     * @param shape Waveform, see \ref waveShape.
+     */
+    Wavetable(int shape);
+
+    // DESCTRUCTOR
+    /**
+     * @brief Standard Destructor.
+     */
+    ~Wavetable();
+
+    /**
+     * @brief Get a shared table of a built-in waveform, which is created on first use.
+     * @param shape Waveform, see \ref waveShape.
+     * @return Return a reference to the table.
+     */
+    static const Wavetable &GetShape(int shape);
+
+    // SETTER
+    /**
+     * @brief Build all mip levels from a fourier series. Index k of the vectors is the
+     *        k-th harmonic, index 0 is the DC offset (only taken from cos_ampl).
+     * @param sin_ampl Amplitudes of the sine components.
+     * @param cos_ampl Amplitudes of the cosine components.
+     * @return Return void.
+     */
+    void SetHarmonics(const std::vector<double> &sin_ampl, const std::vector<double> &cos_ampl);
+
+    /**
+     * @brief Build all mip levels from one period of a waveform.
+     * @param cycle Pointer to the samples of one period.
+     * @param n Number of samples, at least 2.
+     * @return Return void.
+     */
+    void SetWaveform(const float *cycle, size_t n);
+
+    /**
+     * @brief Load one period of a waveform from a mono or multi channel wav file
+     *        (16 bit integer or 32 bit float, only the first channel is used).
+     *        The whole file is taken as one period, like single cycle waveform collections.
+     * @param path Path of the wav file.
+     * @return Return true on success, on failure the table is unchanged.
+     */
+    bool LoadFile(const char *path);
+
+    /**
+     * @brief Make the table silent.
+     * @return Return void.
+     */
+    void Clear();
+
+    /**
+     * @brief Add another table, scaled by an amplitude. As the tables are linear in their
+     *        harmonics, the sum is band-limited as well.
+     * @param table Table to add.
+     * @param a Amplitude as a double.
+     * @return Return void.
+     */
+    void Add(const Wavetable &table, double a);
+
+    /**
+     * @brief Read a block of samples with a constant phase increment.
+     * @param phase Pointer to the phases in radians, range from 0 to 2 pi.
+     * @param inc Phase increment per sample in radians, selects the mip levels.
+     * @param out Pointer to the output samples.
+     * @param n Number of samples.
+     * @return Return void.
+     */
+    void Render(const float *phase, double inc, float *out, size_t n) const;
+
+    /**
+     * @brief Read a single sample.
+     * @param phase Phase in radians, range from 0 to 2 pi.
+     * @param inc Phase increment per sample in radians, selects the mip levels.
+     * @return Return the sample as a float.
+     */
+    float GetSample(double phase, double inc) const;
+
+private:
+    /**
+     * @brief Select the mip level and the crossfade to the next level for a phase increment.
+     * @param inc Phase increment per sample in radians.
+     * @param level Returns the mip level.
+     * @param frac Returns the crossfade from level (0) to level + 1 (1).
+     * @return Return void.
+     */
+    void select_level(double inc, size_t &level, float &frac) const;
+
+    static const size_t kStride = kTableSize + 1;   /**< One guard sample per level for the interpolation. */
+
+    std::vector<float> table_;                      /**< All mip levels, kStride samples each. */
+};
@@ -0,0 +1,54 @@
+//class WavetableOsc
+//
+// band-limited oscillator, which reads its signal from a mipmapped Wavetable
+
+#ifndef WAVETABLEOSC_H
+#define WAVETABLEOSC_H
+
+#include <math.h>
+#include <stddef.h>
+
+#include "wavetable.h"
+
+#define _USE_MATH_DEFINES
+
+class WavetableOsc {
+public:
+    WavetableOsc(const Wavetable *tab, double f, double a, double p, int fS);
+
+    /// getters
+    double frequency();
+    double amplitude();
+    double phase();
+    /// setters (override)
+    void frequency(double f);
+    void amplitude(double a);
+    void phase(double p);
+    void table(const Wavetable *tab);
+
+
+    double getNextSample();
+    double getCurrentAmpl();
+
+    /// render the next n samples into out
+    void renderBlock(float *out, size_t n);
+
+
+
+private:
+
+    // OSCILLATOR STATE
+    double freq;
+    double amp;
+    double phi;
+    double curr_ampl;
+
+    // SYSTEM RELATED
+    int fs;
+
+    // the waveform, not owned by the oscillator
+    const Wavetable *wt;
+
+};
+
+#endif // WAVETABLEOSC_H
@@ -25,9 +25,12 @@
 #include "Biquad.h"
 
 #include <iostream> 
-#include <unistd.h>
 #include <aixlog.hpp>
 
+// log2 of the lowest table cut off frequency and table entries per octave
+static const double kLog2FcMin = log2(Biquad::kTableFcMin);
+static const double kStepsPerOctave = (Biquad::kTableSize - 1) / log2(Biquad::kTableFcMax / Biquad::kTableFcMin);
+
 Biquad::Biquad()
 {
     type_ = filterType::LOWPASS;
@@ -35,6 +38,7 @@ Biquad::Biquad()
     a1_ = a2_ = b1_ = b2_ = 0.0;
     fc_ = 0.50;
     q_ = 0.0;
+    gain_reduce_ = false;
     SetPeakGain(0.0);
     z1_ = z2_ = 0.0;
 }
@@ -46,6 +50,7 @@ Biquad::Biquad(int type, double fc, double q, double peakGain)
     a1_ = a2_ = b1_ = b2_ = 0.0;
     fc_ = fc;
     q_ = q;
+    gain_reduce_ = false;
     SetPeakGain(peakGain);
     z1_ = z2_ = 0.0;
 }
@@ -59,6 +64,7 @@ Biquad::SetType(filterType type)
 {
     type_ = type;
     calc_biquad();
+    build_table();
 
     //  reduce gain for peak, highshelf and lowshelf
     //  This leads to a reduction of the volume, however a high peakGain then works similar to the Q factor
@@ -73,6 +79,7 @@ Biquad::SetQ(double Q)
 {
     q_ = Q;
     calc_biquad();
+    build_table();
 }
 
 void
@@ -93,6 +100,7 @@ Biquad::SetPeakGain(double peakGain)
 {
     peak_gain_ = peakGain;
     calc_biquad();
+    build_table();
 }
 
 // turn on the gain reduction for applicable filter types
@@ -105,110 +113,196 @@ Biquad::SetGainReduce(bool status)
         gain_reduce_ =false;
 }
 
+void
+Biquad::ProcessBlock(float *io, size_t n)
+{
+    // keep coefficients and delays in locals for the inner loop and
+    // evaluate the gain reduction once per block instead of every sample
+    auto a0 = a0_, a1 = a1_, a2 = a2_, b1 = b1_, b2 = b2_;
+    auto z1 = z1_, z2 = z2_;
+    auto gain = gain_reduce_ ? gain_reduce_factor_ : 1.0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        double in = io[i];
+        auto out = in * a0 + z1;
+        z1 = in * a1 + z2 - b1 * out;
+        z2 = in * a2 - b2 * out;
+        io[i] = (float)(out * gain);
+    }
+
+    z1_ = z1;
+    z2_ = z2;
+}
+
+void
+Biquad::ProcessBlock(float *io, const float *fc, size_t n)
+{
+    if (n == 0)
+        return;
+
+    auto z1 = z1_, z2 = z2_;
+    auto gain = gain_reduce_ ? gain_reduce_factor_ : 1.0;
+    auto table = table_.data();
+    double c[5];
+
+    for (size_t i = 0; i < n; i++)
+    {
+        // position in the table, the entries are log-spaced
+        auto pos = (log2(fc[i]) - kLog2FcMin) * kStepsPerOctave;
+        if (!(pos > 0.0))
+            pos = 0.0;
+        if (pos > kTableSize - 1.001)
+            pos = kTableSize - 1.001;
+        auto k = (size_t)pos;
+        auto t = pos - k;
+        auto lo = table + 5 * k;
+        for (int j = 0; j < 5; j++)
+            c[j] = lo[j] + t * (lo[j + 5] - lo[j]);
+
+        double in = io[i];
+        auto out = in * c[0] + z1;
+        z1 = in * c[1] + z2 - c[3] * out;
+        z2 = in * c[2] - c[4] * out;
+        io[i] = (float)(out * gain);
+    }
+
+    z1_ = z1;
+    z2_ = z2;
+
+    // the filter stays at the last cut off frequency
+    fc_ = fc[n - 1];
+    a0_ = c[0];
+    a1_ = c[1];
+    a2_ = c[2];
+    b1_ = c[3];
+    b2_ = c[4];
+}
+
+void
+Biquad::build_table()
+{
+    gain_reduce_factor_ = 1.0 / pow(10, peak_gain_/20);
+
+    table_.resize(5 * kTableSize);
+    for (size_t k = 0; k < kTableSize; k++)
+        calc_coeffs(exp2(kLog2FcMin + k / kStepsPerOctave), &table_[5 * k]);
+}
+
 void
 Biquad::calc_biquad(void) {
+    double c[5];
+    calc_coeffs(fc_, c);
+    a0_ = c[0];
+    a1_ = c[1];
+    a2_ = c[2];
+    b1_ = c[3];
+    b2_ = c[4];
+}
+
+// the formulas work on any cut off frequency, so the filter and its coefficient table share them
+void
+Biquad::calc_coeffs(double fc, double *c) const {
     double norm;
     auto V = std::pow(10, std::fabs(peak_gain_) / 20.0);
-    auto K = std::tan(M_PI * fc_);
+    auto K = std::tan(M_PI * fc);
     switch (type_)
     {
         case filterType::LOWPASS:
             norm = 1 / (1 + K / q_ + K * K);
-            a0_ = K * K * norm;
-            a1_ = 2 * a0_;
-            a2_ = a0_;
-            b1_ = 2 * (K * K - 1) * norm;
-            b2_ = (1 - K / q_ + K * K) * norm;
+            c[0] = K * K * norm;
+            c[1] = 2 * c[0];
+            c[2] = c[0];
+            c[3] = 2 * (K * K - 1) * norm;
+            c[4] = (1 - K / q_ + K * K) * norm;
             break;
             
         case filterType::HIGHPASS:
             norm = 1 / (1 + K / q_ + K * K);
-            a0_ = 1 * norm;
-            a1_ = -2 * a0_;
-            a2_ = a0_;
-            b1_ = 2 * (K * K - 1) * norm;
-            b2_ = (1 - K / q_ + K * K) * norm;
+            c[0] = 1 * norm;
+            c[1] = -2 * c[0];
+            c[2] = c[0];
+            c[3] = 2 * (K * K - 1) * norm;
+            c[4] = (1 - K / q_ + K * K) * norm;
             break;
             
         case filterType::BANDPASS:
             norm = 1 / (1 + K / q_ + K * K);
-            a0_ = K / q_ * norm;
-            a1_ = 0;
-            a2_ = -a0_;
-            b1_ = 2 * (K * K - 1) * norm;
-            b2_ = (1 - K / q_ + K * K) * norm;
+            c[0] = K / q_ * norm;
+            c[1] = 0;
+            c[2] = -c[0];
+            c[3] = 2 * (K * K - 1) * norm;
+            c[4] = (1 - K / q_ + K * K) * norm;
             break;
             
         case filterType::NOTCH:
             norm = 1 / (1 + K / q_ + K * K);
-            a0_ = (1 + K * K) * norm;
-            a1_ = 2 * (K * K - 1) * norm;
-            a2_ = a0_;
-            b1_ = a1_;
-            b2_ = (1 - K / q_ + K * K) * norm;
+            c[0] = (1 + K * K) * norm;
+            c[1] = 2 * (K * K - 1) * norm;
+            c[2] = c[0];
+            c[3] = c[1];
+            c[4] = (1 - K / q_ + K * K) * norm;
             break;
             
         case filterType::PEAK:
             if (peak_gain_ >= 0)
             {    // boost
                 norm = 1 / (1 + 1/q_ * K + K * K);
-                a0_ = (1 + V/q_ * K + K * K) * norm;
-                a1_ = 2 * (K * K - 1) * norm;
-                a2_ = (1 - V/q_ * K + K * K) * norm;
-                b1_ = a1_;
-                b2_ = (1 - 1/q_ * K + K * K) * norm;
+                c[0] = (1 + V/q_ * K + K * K) * norm;
+                c[1] = 2 * (K * K - 1) * norm;
+                c[2] = (1 - V/q_ * K + K * K) * norm;
+                c[3] = c[1];
+                c[4] = (1 - 1/q_ * K + K * K) * norm;
             }
             else
             {    // cut
                 norm = 1 / (1 + V/q_ * K + K * K);
-                a0_ = (1 + 1/q_ * K + K * K) * norm;
-                a1_ = 2 * (K * K - 1) * norm;
-                a2_ = (1 - 1/q_ * K + K * K) * norm;
-                b1_ = a1_;
-                b2_ = (1 - V/q_ * K + K * K) * norm;
+                c[0] = (1 + 1/q_ * K + K * K) * norm;
+                c[1] = 2 * (K * K - 1) * norm;
+                c[2] = (1 - 1/q_ * K + K * K) * norm;
+                c[3] = c[1];
+                c[4] = (1 - V/q_ * K + K * K) * norm;
             }
             break;
         case filterType::LOWSHELF:
             if (peak_gain_ >= 0)
             {   // boost
                 norm = 1 / (1 + sqrt(2) * K + K * K);
-                a0_ = (1 + sqrt(2*V) * K + V * K * K) * norm;
-                a1_ = 2 * (V * K * K - 1) * norm;
-                a2_ = (1 - sqrt(2*V) * K + V * K * K) * norm;
-                b1_ = 2 * (K * K - 1) * norm;
-                b2_ = (1 - sqrt(2) * K + K * K) * norm;
+                c[0] = (1 + sqrt(2*V) * K + V * K * K) * norm;
+                c[1] = 2 * (V * K * K - 1) * norm;
+                c[2] = (1 - sqrt(2*V) * K + V * K * K) * norm;
+                c[3] = 2 * (K * K - 1) * norm;
+                c[4] = (1 - sqrt(2) * K + K * K) * norm;
             }
             else
             {   // cut
                 norm = 1 / (1 + sqrt(2*V) * K + V * K * K);
-                a0_ = (1 + sqrt(2) * K + K * K) * norm;
-                a1_ = 2 * (K * K - 1) * norm;
-                a2_ = (1 - sqrt(2) * K + K * K) * norm;
-                b1_ = 2 * (V * K * K - 1) * norm;
-                b2_ = (1 - sqrt(2*V) * K + V * K * K) * norm;
+                c[0] = (1 + sqrt(2) * K + K * K) * norm;
+                c[1] = 2 * (K * K - 1) * norm;
+                c[2] = (1 - sqrt(2) * K + K * K) * norm;
+                c[3] = 2 * (V * K * K - 1) * norm;
+                c[4] = (1 - sqrt(2*V) * K + V * K * K) * norm;
             }
             break;
         case filterType::HIGHSHELF:
             if (peak_gain_ >= 0)
             {   // boost
                 norm = 1 / (1 + sqrt(2) * K + K * K);
-                a0_ = (V + sqrt(2*V) * K + K * K) * norm;
-                a1_ = 2 * (K * K - V) * norm;
-                a2_ = (V - sqrt(2*V) * K + K * K) * norm;
-                b1_ = 2 * (K * K - 1) * norm;
-                b2_ = (1 - sqrt(2) * K + K * K) * norm;
+                c[0] = (V + sqrt(2*V) * K + K * K) * norm;
+                c[1] = 2 * (K * K - V) * norm;
+                c[2] = (V - sqrt(2*V) * K + K * K) * norm;
+                c[3] = 2 * (K * K - 1) * norm;
+                c[4] = (1 - sqrt(2) * K + K * K) * norm;
             }
             else
             {   // cut
                 norm = 1 / (V + sqrt(2*V) * K + K * K);
-                a0_ = (1 + sqrt(2) * K + K * K) * norm;
-                a1_ = 2 * (K * K - 1) * norm;
-                a2_ = (1 - sqrt(2) * K + K * K) * norm;
-                b1_ = 2 * (K * K - V) * norm;
-                b2_ = (V - sqrt(2*V) * K + K * K) * norm;
+                c[0] = (1 + sqrt(2) * K + K * K) * norm;
+                c[1] = 2 * (K * K - 1) * norm;
+                c[2] = (1 - sqrt(2) * K + K * K) * norm;
+                c[3] = 2 * (K * K - V) * norm;
+                c[4] = (V - sqrt(2*V) * K + K * K) * norm;
             }
             break;
     }
-    usleep(500);
-    return;
 }
@@ -8,9 +8,14 @@
 
 ADSR::ADSR(void)
 {
+    fs_ = kReferenceRate;
     Reset();
 }
 
+ADSR::~ADSR()
+{
+}
+
 float
 ADSR::Process()
 {
@@ -20,9 +25,7 @@ ADSR::Process()
             output_ = 0.001;
         if (old_state_ >= 2)
             output_ = 0.001;
-        // multiplicator goes from 0.04 to 0.00002
-        // with release_time from 1 to 99
-        output_ = output_ + output_ * (1 - (exp(-log10((1.0 + 10) / 10 ) / attack_time_) + 0.0004));
+        output_ = output_ * attack_factor_;
         old_state_ = state_;
         if (output_ >= 0.99)
         {
@@ -32,9 +35,7 @@ ADSR::Process()
     }
     else if (state_ == noteState::DECAY)
     {
-        // multiplicator goes from 0.99924 to 0.999992
-        // with release_time from 1 to 99
-        output_ = output_ * (0.99 + (exp(-log10((2.0 + 10) / 10 ) / decay_time_) / 100));
+        output_ = output_ * decay_factor_;
         old_state_ = state_;
         if (output_ <= sustain_level_ / 100)
             state_ = noteState::SUSTAIN;
@@ -46,9 +47,7 @@ ADSR::Process()
     }
     else if (state_ == noteState::RELEASE)
     {
-        // multiplicator goes from 0.99924 to 0.999992
-        // with release_time from 1 to 99
-        output_ = output_ * (0.99 + (exp(-log10((2.0 + 10) / 10 ) / release_time_) / 100));
+        output_ = output_ * release_factor_;
         old_state_ = state_;
         if (output_ <= 0.001)
         {
@@ -65,6 +64,55 @@ ADSR::Process()
     return output_;
 }
 
+void
+ADSR::ProcessBlock(float *io, size_t n)
+{
+    size_t i = 0;
+    while (i < n)
+    {
+        // one sample with all checks, it enters or leaves a segment
+        io[i++] *= Process();
+
+        // then the samples up to the next state change, without checks
+        size_t m = 0;
+        if (state_ == noteState::ATTACK)
+        {
+            m = samples_before(attack_factor_, 0.99f, n - i);
+            auto out = output_;
+            for (size_t k = 0; k < m; k++)
+            {
+                out *= attack_factor_;
+                io[i + k] *= out;
+            }
+            output_ = out;
+        }
+        else if (state_ == noteState::DECAY || state_ == noteState::RELEASE)
+        {
+            auto factor = (state_ == noteState::DECAY) ? decay_factor_ : release_factor_;
+            auto threshold = (state_ == noteState::DECAY) ? sustain_level_ / 100 : 0.001f;
+            m = samples_before(factor, threshold, n - i);
+            auto out = output_;
+            for (size_t k = 0; k < m; k++)
+            {
+                out *= factor;
+                io[i + k] *= out;
+            }
+            output_ = out;
+        }
+        else
+        {
+            // sustain and off are constant until the next SetState,
+            // Process sets the level, if the state has just changed
+            m = n - i;
+            if (m > 0)
+                Process();
+            for (size_t k = 0; k < m; k++)
+                io[i + k] *= output_;
+        }
+        i += m;
+    }
+}
+
 void
 ADSR::Reset()
 {
@@ -75,4 +123,37 @@ ADSR::Reset()
     decay_time_ = 1.0;
     sustain_level_ = 99;
     release_time_ = 1.0;
-}
\ No newline at end of file
+    update_factors();
+}
+
+void
+ADSR::update_factors()
+{
+    // factors of the curves at the reference rate, the attack one goes from 1.04 to 1.00042,
+    // the decay and release ones from 0.99924 to 0.999992, with times from 1 to 99
+    auto attack = 1.0 + (1.0 - (exp(-log10((1.0 + 10) / 10) / attack_time_) + 0.0004));
+    auto decay = 0.99 + exp(-log10((2.0 + 10) / 10) / decay_time_) / 100;
+    auto release = 0.99 + exp(-log10((2.0 + 10) / 10) / release_time_) / 100;
+
+    // same duration at any sample rate
+    auto ratio = kReferenceRate / fs_;
+    attack_factor_ = (float)pow(attack, ratio);
+    decay_factor_ = (float)pow(decay, ratio);
+    release_factor_ = (float)pow(release, ratio);
+}
+
+size_t
+ADSR::samples_before(float factor, float threshold, size_t max)
+{
+    if (output_ <= 0.0f || threshold <= 0.0f || factor == 1.0f)
+        return (threshold <= 0.0f) ? max : 0;
+
+    // samples until the threshold is crossed, less one for rounding, the crossing
+    // itself is left to Process
+    auto steps = ceil(log(threshold / output_) / log(factor)) - 2.0;
+    if (!(steps > 0.0))
+        return 0;
+    if (steps >= (double)max)
+        return max;
+    return (size_t)steps;
+}
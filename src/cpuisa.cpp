@@ -0,0 +1,52 @@
+/**
+ * @file cpuisa.cpp
+ * @brief CpuIsa class implementation.
+ */
+
+#include "cpuisa.h"
+
+// the best supported instruction set
+static int
+detect_isa()
+{
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return ISA_AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return ISA_AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return ISA_SSE2;
+#endif
+    return ISA_SCALAR;
+}
+
+int
+CpuIsa::Get()
+{
+    // detected on the first call, also when that is part of the static initialization
+    static const int isa = detect_isa();
+    return isa;
+}
+
+bool
+CpuIsa::IsSupported(int isa)
+{
+    return isa >= ISA_SCALAR && isa <= Get();
+}
+
+const char *
+CpuIsa::GetName(int isa)
+{
+    switch (isa)
+    {
+        case ISA_SSE2:
+            return "sse2";
+        case ISA_AVX2:
+            return "avx2";
+        case ISA_AVX512:
+            return "avx512";
+        default:
+            return "scalar";
+    }
+}
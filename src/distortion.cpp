@@ -6,22 +6,233 @@
 
 #include "distortion.h"
 
+#include <algorithm>
+
+// atan in units of pi / 2, the table is wide enough for any sensible signal level
+static double
+atan_shape(double x)
+{
+    return (2.0 / M_PI) * std::atan(x);
+}
+
+static const float kShapeRange = 64.0f;
+
+// below this distance of two inputs the ADAA quotients are replaced by the curve at their mean
+static const double kIllConditioned = 1e-4;
+
+// curves of the ADAA models, of the input after the drive: the curve f, its antiderivative F1
+// and, for the second order, the second antiderivative F2
+struct atanCurve
+{
+    static double f(double u)   { return (2.0 / M_PI) * std::atan(u); }
+    static double F1(double u)  { return (2.0 / M_PI) * (u * std::atan(u) - 0.5 * std::log1p(u * u)); }
+    static double F2(double u)  { return (1.0 / M_PI) * ((u * u - 1.0) * std::atan(u) + u - u * std::log1p(u * u)); }
+};
+
+struct tanhCurve
+{
+    static double f(double u)   { return std::tanh(u); }
+    // log(cosh(u)), in a form which does not overflow
+    static double F1(double u)  { auto a = std::fabs(u); return a + std::log1p(std::exp(-2.0 * a)) - M_LN2; }
+};
+
+struct hardclipCurve
+{
+    static double f(double u)   { return std::min(1.0, std::max(-1.0, u)); }
+    static double F1(double u)  { auto a = std::fabs(u); return (a <= 1.0) ? 0.5 * u * u : a - 0.5; }
+};
+
+// a triangle with period 4, which is the identity in [-1, 1]; its antiderivative is periodic,
+// since the triangle has no mean
+struct wavefolderCurve
+{
+    static double phase(double u)   { auto p = u + 1.0; return p - 4.0 * std::floor(0.25 * p); }
+    static double f(double u)       { auto p = phase(u); return (p < 2.0) ? p - 1.0 : 3.0 - p; }
+    static double F1(double u)
+    {
+        auto p = phase(u);
+        return (p < 2.0) ? 0.5 * (p - 1.0) * (p - 1.0) - 0.5 : 0.5 - 0.5 * (3.0 - p) * (3.0 - p);
+    }
+};
+
 Distortion::Distortion()
+    : shaper_(atan_shape, kShapeRange), oversampler_(kChunkSize)
 {
     drive_ = 1.0;
     range_ = 0.8;
-    blend_ = 0.8;
+    model_ = DISTORTION_ATAN;
+    prev_[0] = prev_[1] = 0.0;
+    SetBlend(0.8);
 }
 
 Distortion::Distortion(double drive)
+    : shaper_(atan_shape, kShapeRange), oversampler_(kChunkSize)
 {
     drive_ = drive;
+    range_ = 0.8;
+    model_ = DISTORTION_ATAN;
+    prev_[0] = prev_[1] = 0.0;
+    SetBlend(0.8);
 }
 
 Distortion::~Distortion()
 {
 }
 
+void
+Distortion::ProcessBlock(float *io, size_t n)
+{
+    oversampler_.Process(io, n, [this](float *x, size_t m) { shape(x, m); });
+}
+
+double
+Distortion::GetLatency()
+{
+    // the ADAA models delay by half a sample per order, at the rate they run at
+    double order = 0.0;
+    if (model_ == DISTORTION_ATAN_ADAA2)
+        order = 2.0;
+    else if (model_ != DISTORTION_ATAN)
+        order = 1.0;
+    return oversampler_.GetLatency() + 0.5 * order / (double)oversampler_.GetFactor();
+}
+
+void
+Distortion::ProcessBlockAtan(float *io, size_t n)
+{
+    auto wet = (2.0 / M_PI) * blend_;
+    auto dry = 1.0 / blend_;
+
+    for (size_t i = 0; i < n; i++)
+        io[i] = (float)(wet * std::atan(drive_ * io[i]) + io[i] * dry);
+}
+
+void
+Distortion::shape(float *io, size_t n)
+{
+    switch (model_)
+    {
+    case DISTORTION_ATAN_ADAA1:
+        adaa1<atanCurve>(io, n);
+        return;
+    case DISTORTION_ATAN_ADAA2:
+        adaa2<atanCurve>(io, n);
+        return;
+    case DISTORTION_TANH:
+        adaa1<tanhCurve>(io, n);
+        return;
+    case DISTORTION_HARDCLIP:
+        adaa1<hardclipCurve>(io, n);
+        return;
+    case DISTORTION_WAVEFOLDER:
+        adaa1<wavefolderCurve>(io, n);
+        return;
+    }
+
+    auto drive = (float)drive_;
+    auto wet = wet_;
+    auto dry = dry_;
+
+    for (size_t i = 0; i < n; i++)
+        io[i] = wet * shaper_.Process(drive * io[i]) + dry * io[i];
+}
+
+template <typename Curve>
+void
+Distortion::adaa1(float *io, size_t n)
+{
+    auto drive = drive_;
+    double wet = wet_;
+    double dry = dry_;
+
+    // the antiderivative of the last input is carried along, one evaluation per sample
+    auto x1 = prev_[0];
+    auto x2 = prev_[1];
+    auto u1 = drive * x1;
+    auto F1_1 = Curve::F1(u1);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        double x0 = io[i];
+        auto u0 = drive * x0;
+        auto F1_0 = Curve::F1(u0);
+        auto du = u0 - u1;
+
+        auto shaped = (std::fabs(du) < kIllConditioned) ? Curve::f(0.5 * (u0 + u1)) : (F1_0 - F1_1) / du;
+        // the first order ADAA of the identity
+        io[i] = (float)(wet * shaped + dry * 0.5 * (x0 + x1));
+
+        x2 = x1;
+        x1 = x0;
+        u1 = u0;
+        F1_1 = F1_0;
+    }
+
+    prev_[0] = x1;
+    prev_[1] = x2;
+}
+
+template <typename Curve>
+void
+Distortion::adaa2(float *io, size_t n)
+{
+    auto drive = drive_;
+    double wet = wet_;
+    double dry = dry_;
+
+    // first order difference quotient of F2, the curve at the mean if a and b are too close
+    auto difference = [](double a, double b, double F2_a, double F2_b) {
+        auto d = a - b;
+        return (std::fabs(d) < kIllConditioned) ? Curve::F1(0.5 * (a + b)) : (F2_a - F2_b) / d;
+    };
+
+    // F2 of the last input and the quotient of the last two inputs are carried along, so a
+    // sample costs one evaluation of F2 and one quotient, as the first order
+    auto x1 = prev_[0];
+    auto x2 = prev_[1];
+    auto u1 = drive * x1;
+    auto u2 = drive * x2;
+    auto F2_1 = Curve::F2(u1);
+    auto d1 = difference(u1, u2, F2_1, Curve::F2(u2));
+
+    for (size_t i = 0; i < n; i++)
+    {
+        double x0 = io[i];
+        auto u0 = drive * x0;
+        auto F2_0 = Curve::F2(u0);
+        auto d0 = difference(u0, u1, F2_0, F2_1);
+        auto du = u0 - u2;
+
+        double shaped;
+        if (std::fabs(du) >= kIllConditioned)
+        {
+            shaped = 2.0 * (d0 - d1) / du;
+        }
+        else
+        {
+            // the outer inputs coincide, expand around their mean instead
+            auto mean = 0.5 * (u0 + u2);
+            auto delta = mean - u1;
+            if (std::fabs(delta) < kIllConditioned)
+                shaped = Curve::f(0.5 * (mean + u1));
+            else
+                shaped = 2.0 / delta * (Curve::F1(mean) + (F2_1 - Curve::F2(mean)) / delta);
+        }
+        // the second order ADAA of the identity
+        io[i] = (float)(wet * shaped + dry * (x0 + 4.0 * x1 + x2) * (1.0 / 6.0));
+
+        x2 = x1;
+        x1 = x0;
+        u2 = u1;
+        u1 = u0;
+        F2_1 = F2_0;
+        d1 = d0;
+    }
+
+    prev_[0] = x1;
+    prev_[1] = x2;
+}
+
 void
 Distortion::SetDrive(double drive)
 {
@@ -34,8 +245,21 @@ Distortion::SetRange(double range)
     range_ = range;
 }
 
+void
+Distortion::SetModel(int model)
+{
+    if (model < 0 || model >= DISTORTION_MODEL_COUNT)
+        return;
+
+    model_ = model;
+    prev_[0] = prev_[1] = 0.0;
+}
+
 void
 Distortion::SetBlend(double blend)
 {
     blend_ = blend;
+    // the table holds the atan in units of pi / 2 already
+    wet_ = (float)blend_;
+    dry_ = (float)(1.0 / blend_);
 }
\ No newline at end of file
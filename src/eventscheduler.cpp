@@ -0,0 +1,59 @@
+/**
+ * @file eventscheduler.cpp
+ * @brief EventScheduler class implementation.
+ */
+
+#include "eventscheduler.h"
+
+EventScheduler::EventScheduler()
+{
+    count_ = 0;
+}
+
+EventScheduler::~EventScheduler()
+{
+}
+
+void
+EventScheduler::Advance(size_t applied, size_t n)
+{
+    if (applied > count_)
+        applied = count_;
+
+    for (size_t i = applied; i < count_; i++)
+    {
+        events_[i - applied] = events_[i];
+        events_[i - applied].frame -= (double)n;
+    }
+    count_ -= applied;
+}
+
+bool
+EventScheduler::Add(double frame, const synthCommand &cmd)
+{
+    // also rejects NaN
+    if (count_ >= kMaxEvents || !(frame >= 0.0))
+        return false;
+
+    events_[count_].frame = frame;
+    events_[count_].cmd = cmd;
+    count_++;
+    return true;
+}
+
+void
+EventScheduler::Sort()
+{
+    // insertion sort, stable and fast for the few, mostly ordered events of a period
+    for (size_t i = 1; i < count_; i++)
+    {
+        auto ev = events_[i];
+        auto j = i;
+        while (j > 0 && events_[j - 1].frame > ev.frame)
+        {
+            events_[j] = events_[j - 1];
+            j--;
+        }
+        events_[j] = ev;
+    }
+}
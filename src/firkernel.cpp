@@ -0,0 +1,179 @@
+/**
+ * @file firkernel.cpp
+ * @brief FirKernel class implementation.
+ */
+
+#include "firkernel.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define FIRKERNEL_X86
+#include <immintrin.h>
+#endif
+
+// the outputs from i to n - 1, one at a time
+static void
+process_tail(const float *c, size_t taps, const float *in, float *out, size_t i, size_t n)
+{
+    for (; i < n; i++)
+    {
+        float acc = 0.0f;
+        for (size_t t = 0; t < taps; t++)
+            acc += c[t] * in[i + t];
+        out[i] = acc;
+    }
+}
+
+static void
+process_scalar(const float *c, size_t taps, const float *in, float *out, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        float acc0 = 0.0f, acc1 = 0.0f, acc2 = 0.0f, acc3 = 0.0f;
+        for (size_t t = 0; t < taps; t++)
+        {
+            auto x = in + i + t;
+            acc0 += c[t] * x[0];
+            acc1 += c[t] * x[1];
+            acc2 += c[t] * x[2];
+            acc3 += c[t] * x[3];
+        }
+        out[i] = acc0;
+        out[i + 1] = acc1;
+        out[i + 2] = acc2;
+        out[i + 3] = acc3;
+    }
+    process_tail(c, taps, in, out, i, n);
+}
+
+#ifdef FIRKERNEL_X86
+
+__attribute__((target("sse2")))
+static void
+process_sse2(const float *c, size_t taps, const float *in, float *out, size_t n)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        auto acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+        auto acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+        for (size_t t = 0; t < taps; t++)
+        {
+            auto ct = _mm_set1_ps(c[t]);
+            auto x = in + i + t;
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(ct, _mm_loadu_ps(x)));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(ct, _mm_loadu_ps(x + 4)));
+            acc2 = _mm_add_ps(acc2, _mm_mul_ps(ct, _mm_loadu_ps(x + 8)));
+            acc3 = _mm_add_ps(acc3, _mm_mul_ps(ct, _mm_loadu_ps(x + 12)));
+        }
+        _mm_storeu_ps(out + i, acc0);
+        _mm_storeu_ps(out + i + 4, acc1);
+        _mm_storeu_ps(out + i + 8, acc2);
+        _mm_storeu_ps(out + i + 12, acc3);
+    }
+    for (; i + 4 <= n; i += 4)
+    {
+        auto acc = _mm_setzero_ps();
+        for (size_t t = 0; t < taps; t++)
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(c[t]), _mm_loadu_ps(in + i + t)));
+        _mm_storeu_ps(out + i, acc);
+    }
+    process_tail(c, taps, in, out, i, n);
+}
+
+__attribute__((target("avx2,fma")))
+static void
+process_avx2(const float *c, size_t taps, const float *in, float *out, size_t n)
+{
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        auto acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+        auto acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+        for (size_t t = 0; t < taps; t++)
+        {
+            auto ct = _mm256_set1_ps(c[t]);
+            auto x = in + i + t;
+            acc0 = _mm256_fmadd_ps(ct, _mm256_loadu_ps(x), acc0);
+            acc1 = _mm256_fmadd_ps(ct, _mm256_loadu_ps(x + 8), acc1);
+            acc2 = _mm256_fmadd_ps(ct, _mm256_loadu_ps(x + 16), acc2);
+            acc3 = _mm256_fmadd_ps(ct, _mm256_loadu_ps(x + 24), acc3);
+        }
+        _mm256_storeu_ps(out + i, acc0);
+        _mm256_storeu_ps(out + i + 8, acc1);
+        _mm256_storeu_ps(out + i + 16, acc2);
+        _mm256_storeu_ps(out + i + 24, acc3);
+    }
+    for (; i + 8 <= n; i += 8)
+    {
+        auto acc = _mm256_setzero_ps();
+        for (size_t t = 0; t < taps; t++)
+            acc = _mm256_fmadd_ps(_mm256_set1_ps(c[t]), _mm256_loadu_ps(in + i + t), acc);
+        _mm256_storeu_ps(out + i, acc);
+    }
+    process_tail(c, taps, in, out, i, n);
+}
+
+__attribute__((target("avx512f")))
+static void
+process_avx512(const float *c, size_t taps, const float *in, float *out, size_t n)
+{
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64)
+    {
+        auto acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+        auto acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+        for (size_t t = 0; t < taps; t++)
+        {
+            auto ct = _mm512_set1_ps(c[t]);
+            auto x = in + i + t;
+            acc0 = _mm512_fmadd_ps(ct, _mm512_loadu_ps(x), acc0);
+            acc1 = _mm512_fmadd_ps(ct, _mm512_loadu_ps(x + 16), acc1);
+            acc2 = _mm512_fmadd_ps(ct, _mm512_loadu_ps(x + 32), acc2);
+            acc3 = _mm512_fmadd_ps(ct, _mm512_loadu_ps(x + 48), acc3);
+        }
+        _mm512_storeu_ps(out + i, acc0);
+        _mm512_storeu_ps(out + i + 16, acc1);
+        _mm512_storeu_ps(out + i + 32, acc2);
+        _mm512_storeu_ps(out + i + 48, acc3);
+    }
+    for (; i + 16 <= n; i += 16)
+    {
+        auto acc = _mm512_setzero_ps();
+        for (size_t t = 0; t < taps; t++)
+            acc = _mm512_fmadd_ps(_mm512_set1_ps(c[t]), _mm512_loadu_ps(in + i + t), acc);
+        _mm512_storeu_ps(out + i, acc);
+    }
+    process_tail(c, taps, in, out, i, n);
+}
+
+#endif // FIRKERNEL_X86
+
+void
+FirKernel::Process(const float *coeffs, size_t taps, const float *in, float *out, size_t n)
+{
+    ProcessWith(CpuIsa::Get(), coeffs, taps, in, out, n);
+}
+
+void
+FirKernel::ProcessWith(int isa, const float *coeffs, size_t taps, const float *in, float *out,
+                       size_t n)
+{
+    switch (isa)
+    {
+#ifdef FIRKERNEL_X86
+        case ISA_AVX512:
+            process_avx512(coeffs, taps, in, out, n);
+            break;
+        case ISA_AVX2:
+            process_avx2(coeffs, taps, in, out, n);
+            break;
+        case ISA_SSE2:
+            process_sse2(coeffs, taps, in, out, n);
+            break;
+#endif
+        default:
+            process_scalar(coeffs, taps, in, out, n);
+            break;
+    }
+}
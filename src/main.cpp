@@ -1,4 +1,6 @@
 #include <signal.h>
+#include <getopt.h>
+#include <stdlib.h>
 #include <aixlog.hpp>
 
 #include "osc_synth.h"
@@ -13,17 +15,74 @@ void exitSigHandler(int s)
 	done = true; 
 }
 
+// Command line help
+void printUsage(const char *name)
+{
+	std::cout << "Usage: " << name << " [options]\n"
+			  << "  -v, --voices N       polyphony, 1 to " << OSCSynth::kMaxVoices << " (default 7)\n"
+			  << "  -t, --threads N      cores rendering the voices, 1 to " << OSCSynth::kMaxThreads << " (default 1)\n"
+			  << "  -b, --buffered       render in the main loop through a ring buffer (more latency)\n"
+			  << "  -j, --jack-midi      read midi from the jack port midi_in, sample accurate\n"
+			  << "  -w, --waveform FILE  single cycle wav file for the user waveform (/WaveAmpl)\n"
+			  << "  -h, --help           show this help\n";
+}
+
 int main(int argc, char *argv[])
 {
-	(void)argc;
-	(void)argv;
+	// Command line options
+	size_t voices = 7;
+	size_t threads = 1;
+	bool direct = true;
+	bool jack_midi = false;
+	const char *waveform = NULL;
+
+	static const struct option longOptions[] = {
+		{"voices",		required_argument,	NULL, 'v'},
+		{"threads",		required_argument,	NULL, 't'},
+		{"buffered",	no_argument,		NULL, 'b'},
+		{"jack-midi",	no_argument,		NULL, 'j'},
+		{"waveform",	required_argument,	NULL, 'w'},
+		{"help",		no_argument,		NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	int opt;
+	while ((opt = getopt_long(argc, argv, "v:t:bjw:h", longOptions, NULL)) != -1) {
+		switch (opt) {
+			case 'v':
+				voices = strtoul(optarg, NULL, 10);
+				break;
+			case 't':
+				threads = strtoul(optarg, NULL, 10);
+				break;
+			case 'b':
+				direct = false;
+				break;
+			case 'j':
+				jack_midi = true;
+				break;
+			case 'w':
+				waveform = optarg;
+				break;
+			case 'h':
+				printUsage(argv[0]);
+				return 0;
+			default:
+				printUsage(argv[0]);
+				return 1;
+		}
+	}
 
 	auto sink_cout = std::make_shared<AixLog::SinkCout>(AixLog::Severity::trace);
     auto sink_file = std::make_shared<AixLog::SinkFile>(AixLog::Severity::trace, "date.log");
     AixLog::Log::init({sink_cout, sink_file});
     
     // create synthesizer object/client
-    OSCSynth *synth = new OSCSynth();
+    OSCSynth *synth = new OSCSynth(voices, threads, direct, jack_midi);
+
+    // load the user waveform
+    if (waveform != NULL)
+    	synth->loadWaveform(waveform);
 
     // activate the client
     synth->start();
@@ -41,15 +100,13 @@ int main(int argc, char *argv[])
 
 	// Main Program Loop
 	while(!done) {
-		// calls the midi handler to process midi events
-		synth->midiHandler();
-		// calls the osc handler to process osc events
-		synth->oscHandler();
-		// calls the lfo handler to calculate the filter coefficients
-		synth->lfoHandler();
+		// midi and osc events go from their server threads straight to the rendering thread
+		synth->reportOverflows();
 
+		// fills the ring buffer, only in buffered mode, the jack callback renders otherwise
 		synth->process();
-		//usleep(5);
+		// in direct mode there is nothing to do here but the overflow report
+		usleep((direct || jack_midi) ? 100000 : 500);
     }
 
     synth->disconnectOutPort(0);		// Disconnecting ports
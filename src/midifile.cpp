@@ -0,0 +1,194 @@
+/**
+ * @file midifile.cpp
+ * @brief MidiFile class implementation.
+ */
+
+#include "midifile.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string.h>
+#include <aixlog.hpp>
+
+// tempo of a file without set tempo events, 120 bpm
+static const uint32_t kDefaultTempo = 500000;
+
+MidiFile::MidiFile()
+{
+    length_ = 0.0;
+}
+
+MidiFile::~MidiFile()
+{
+}
+
+bool
+MidiFile::read_track(const uint8_t *data, size_t size, std::vector<tickEvent> &events,
+                     uint64_t &end_tick)
+{
+    size_t pos = 0;
+    uint64_t tick = 0;
+    uint8_t running = 0;
+
+    // variable length quantity, 7 bits per byte, most significant first
+    auto vlq = [&](uint32_t &value) {
+        value = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            if (pos >= size)
+                return false;
+            auto byte = data[pos++];
+            value = (value << 7) | (byte & 0x7F);
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    };
+
+    while (pos < size)
+    {
+        uint32_t delta;
+        if (!vlq(delta) || pos >= size)
+            return false;
+        tick += delta;
+
+        auto status = data[pos];
+        if (status & 0x80)
+            pos++;
+        else if (running != 0)
+            // running status, the byte is already the first data byte
+            status = running;
+        else
+            return false;
+
+        if (status == 0xFF)
+        {
+            // meta event: type, length, data
+            if (pos >= size)
+                return false;
+            auto type = data[pos++];
+            uint32_t length;
+            if (!vlq(length) || pos + length > size)
+                return false;
+            if (type == 0x51 && length == 3)
+            {
+                tickEvent ev = {tick, 0, 0, 0, 0};
+                ev.tempo = ((uint32_t)data[pos] << 16) | ((uint32_t)data[pos + 1] << 8) | data[pos + 2];
+                events.push_back(ev);
+            }
+            pos += length;
+            if (type == 0x2F)
+                break;
+        }
+        else if (status == 0xF0 || status == 0xF7)
+        {
+            // sysex, skipped, it also cancels the running status
+            uint32_t length;
+            if (!vlq(length) || pos + length > size)
+                return false;
+            pos += length;
+            running = 0;
+        }
+        else
+        {
+            // channel message, program change and channel pressure have one data byte
+            auto type = status & 0xF0;
+            size_t bytes = (type == 0xC0 || type == 0xD0) ? 1 : 2;
+            if (pos + bytes > size)
+                return false;
+            tickEvent ev = {tick, 0, status, data[pos], (uint8_t)((bytes == 2) ? data[pos + 1] : 0)};
+            events.push_back(ev);
+            pos += bytes;
+            running = status;
+        }
+    }
+
+    end_tick = std::max(end_tick, tick);
+    return true;
+}
+
+bool
+MidiFile::Load(const char *path)
+{
+    events_.clear();
+    length_ = 0.0;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        LOG(ERROR) << "MidiFile: could not open " << path << "\n";
+        return false;
+    }
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    // chunk sizes and the header are big endian
+    auto u16 = [&](size_t pos) { return ((uint32_t)data[pos] << 8) | data[pos + 1]; };
+    auto u32 = [&](size_t pos) { return (u16(pos) << 16) | u16(pos + 2); };
+
+    if (data.size() < 14 || memcmp(&data[0], "MThd", 4) != 0 || u32(4) < 6)
+    {
+        LOG(ERROR) << "MidiFile: " << path << " is not a midi file\n";
+        return false;
+    }
+
+    auto format = u16(8);
+    auto division = u16(12);
+    auto smpte = (division & 0x8000) != 0;
+    if (format > 1 || division == 0 || (smpte && (division & 0xFF) == 0))
+    {
+        LOG(ERROR) << "MidiFile: unsupported format " << format << " in " << path << "\n";
+        return false;
+    }
+
+    std::vector<tickEvent> events;
+    uint64_t end_tick = 0;
+    size_t pos = 8 + u32(4);
+    while (pos + 8 <= data.size())
+    {
+        auto size = (size_t)u32(pos + 4);
+        auto body = pos + 8;
+        if (body + size > data.size())
+            size = data.size() - body;
+
+        if (memcmp(&data[pos], "MTrk", 4) == 0 && !read_track(&data[body], size, events, end_tick))
+        {
+            LOG(ERROR) << "MidiFile: truncated track in " << path << "\n";
+            return false;
+        }
+        pos = body + size;
+    }
+
+    // all tracks by tick, the events of one track and the tracks keep their order
+    std::stable_sort(events.begin(), events.end(),
+                     [](const tickEvent &a, const tickEvent &b) { return a.tick < b.tick; });
+
+    // seconds per tick, changed by every set tempo event unless the division is smpte
+    // (frames per second as a negative byte, ticks per frame)
+    double seconds_per_tick;
+    if (smpte)
+        seconds_per_tick = 1.0 / ((double)-(int8_t)(division >> 8) * (double)(division & 0xFF));
+    else
+        seconds_per_tick = kDefaultTempo * 1e-6 / division;
+
+    double time = 0.0;
+    uint64_t tick = 0;
+    for (auto &ev : events)
+    {
+        time += (double)(ev.tick - tick) * seconds_per_tick;
+        tick = ev.tick;
+
+        if (ev.tempo != 0)
+        {
+            if (!smpte)
+                seconds_per_tick = ev.tempo * 1e-6 / division;
+            continue;
+        }
+
+        midiFileEvent out = {time, ev.status, ev.data1, ev.data2};
+        events_.push_back(out);
+    }
+    length_ = time + (double)(end_tick - tick) * seconds_per_tick;
+
+    return true;
+}
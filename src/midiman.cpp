@@ -5,16 +5,12 @@
 
 #include "midiman.h"
 
+#include <time.h>
 #include <aixlog.hpp>
 
-std::vector<unsigned char>  a;
-// vector to buffer the incoming data from rt midi
-std::vector<unsigned char>  buffer;
-// vector to safe the time instances
-std::vector<double>  Zeit;
-
-MidiMan::MidiMan()
+MidiMan::MidiMan() : events(kQueueSize)
 {
+	isVerbose = false;
 
     // rtmidid intit
 	RtMidi::Api api = RtMidi::UNSPECIFIED;
@@ -27,85 +23,68 @@ MidiMan::MidiMan()
     //unsigned int nPorts = midiin->getPortCount();
 
     midiin->openPort( 0 );
-    // Don't ignore sysex, timing, or active sensing messages.
-    midiin->ignoreTypes( false, false, false );
-	isVerbose = false;
+    // the messages are pushed by RtMidi, nobody polls
+    midiin->setCallback(&MidiMan::midiCallback, this);
+    // Ignore sysex, timing, and active sensing messages, only channel messages are used.
+    midiin->ignoreTypes( true, true, true );
 
     LOG(INFO) << "Started Midi Server!\n";
 
 }
 
+MidiMan::~MidiMan()
+{
+    // no callback may run while the ring is destroyed
+    midiin->cancelCallback();
+    midiin->closePort();
+    delete midiin;
+}
+
 void
 MidiMan::setVerbose()
 {
     isVerbose = true;
 }
 
-midiMessage
-MidiMan::get_rtmidi()
+uint32_t
+MidiMan::now()
 {
-	midiMessage mm = {-1,-1,-1, 0, false};
-    
-    int nBytes = 1;
-
-    /// this is kind of a dirty workaroud -
-    /// we loop over all in-messages and take the last one:
-    while(nBytes>0) {
-		
-		stamp=midiin->getMessage(&a);
-		nBytes = a.size();
-
-        /// only do something if bytes are received
-        if (nBytes!=0)
-        {      
-
-			/// only give feedback if 'verbose-mode' is active
-            if (isVerbose == true)
-            {
-                LOG(DEBUG) << "received " << nBytes << "Bytes: " ;
-
-                for (int i=0; i<nBytes; i++ )
-                    LOG(DEBUG) <<  i << " = " << (int)a[i] << " -- " ;
-
-            }
-
-            // fill the buffer and the time vector by inserting new instances in the beginning
-            buffer.insert(buffer.begin(), {a[0], a[1], a[2]});
-            Zeit.insert(Zeit.begin(), stamp);
-
-        }
-
-	sleep(0.01);
-    
-	}
-
-    //	when the buffer holds at least 1 entry which consits of 3 values
-    //	the MidiMessage is loaded with the oldest available values which are then being deleted
-    if(buffer.size()>=3) {
-		mm.byte3 = buffer.back();
-		buffer.pop_back();
-		mm.byte2 = buffer.back();
-		buffer.pop_back();
-		mm.byte1 = buffer.back();
-		buffer.pop_back();
-		mm.stamp=Zeit.back();
-		Zeit.pop_back();
-
-    }
-    
-    return mm;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000);
 }
 
-
-
-
-//////////////////////////////////////////////////////////////////
-// FLUSH the buffer
-//////////////////////////////////////////////////////////////////
-
 void
-MidiMan::flushProcessedMessages()
+MidiMan::midiCallback(double deltatime, std::vector<unsigned char> *message, void *userData)
 {
-   buffer.clear();
+    (void)deltatime;
+    auto statCast = static_cast<MidiMan*>(userData);
+
+    auto nBytes = message->size();
+    if (nBytes == 0 || nBytes > 3)
+        return;
+
+    midiEvent ev;
+    ev.time = now();
+    ev.status = (*message)[0];
+    ev.data1 = (nBytes > 1) ? (*message)[1] : 0;
+    ev.data2 = (nBytes > 2) ? (*message)[2] : 0;
+    ev.size = (uint8_t)nBytes;
+
+    /// only give feedback if 'verbose-mode' is active
+    if (statCast->isVerbose)
+        LOG(DEBUG) << "received " << nBytes << " Bytes: " << (int)ev.status << " " << (int)ev.data1
+                   << " " << (int)ev.data2 << " at " << ev.time << " us\n";
+
+    // a full ring counts the event, see getOverflows
+    statCast->events.Push(ev);
 }
 
+size_t
+MidiMan::drainEvents(midiEvent *out, size_t max)
+{
+    size_t n = 0;
+    while (n < max && events.Pop(out[n]))
+        n++;
+    return n;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file modmatrix.cpp
+ * @brief ModMatrix class implementation.
+ */
+
+#include "modmatrix.h"
+
+#include <string.h>
+
+ModMatrix::ModMatrix()
+{
+    memset(sources_, 0, sizeof(sources_));
+    memset(base_, 0, sizeof(base_));
+    memset(value_, 0, sizeof(value_));
+    route_count_ = 0;
+    target_count_ = 0;
+}
+
+ModMatrix::~ModMatrix()
+{
+}
+
+int
+ModMatrix::AddRoute(int source, int target, float depth)
+{
+    if (source < 0 || source >= MOD_SRC_COUNT || target < 0 || target >= PARAM_COUNT
+        || route_count_ >= kMaxRoutes)
+        return -1;
+
+    auto known = false;
+    for (size_t i = 0; i < target_count_; i++)
+        known = known || (targets_[i] == target);
+    if (!known)
+        targets_[target_count_++] = target;
+
+    route_source_[route_count_] = (uint16_t)source;
+    route_target_[route_count_] = (uint16_t)target;
+    route_depth_[route_count_] = depth;
+    return (int)route_count_++;
+}
+
+void
+ModMatrix::ClearRoutes()
+{
+    route_count_ = 0;
+    target_count_ = 0;
+}
+
+void
+ModMatrix::Evaluate()
+{
+    memcpy(value_, base_, sizeof(value_));
+    for (size_t i = 0; i < route_count_; i++)
+        value_[route_target_[i]] += route_depth_[i] * sources_[route_source_[i]];
+}
+
+void
+ModMatrix::SetSource(int source, float value)
+{
+    if (source >= 0 && source < MOD_SRC_COUNT)
+        sources_[source] = value;
+}
+
+void
+ModMatrix::SetBase(int target, float value)
+{
+    if (target >= 0 && target < PARAM_COUNT)
+    {
+        base_[target] = value;
+        value_[target] = value;
+    }
+}
+
+void
+ModMatrix::SetDepth(size_t route, float depth)
+{
+    if (route < route_count_)
+        route_depth_[route] = depth;
+}
@@ -4,32 +4,34 @@
 
 #include "noise.h"
 
-Noise::Noise(double a) {
+Noise::Noise(double a, uint32_t seed) {
     amp     = a;
+    NoiseKernel::Seed(state, seed);
 }
 
 double Noise::getNextSample() {
 
     /// This method gets the next sample of the Noise signal.
 
-	double thisVal = 0.0;
+	// random number in the signal range (-amp to amp)
+	float thisVal;
+	NoiseKernel::Process(state, &thisVal, (float)amp, 1);
 
-	float a = -amp; 
-	float b = amp;
+	curr_ampl = thisVal;
+
+    return thisVal;
 
-	// generates random float number between 0 an 1
-	float random = ((float) rand()) / (float) RAND_MAX;
-	// defines signal range
-	float diff = b - a;
+}
 
-	// random number is caled to signal range (-1 to 1)
-	float r = random * diff;
-	thisVal = a + r;
+void Noise::renderBlock(float *out, size_t n) {
 
-	curr_ampl = thisVal;
+    /// This method renders the next n samples of the Noise signal.
 
-    return thisVal;
+	// random numbers in the signal range, a whole block at once
+	NoiseKernel::Process(state, out, (float)amp, n);
 
+	if (n > 0)
+		curr_ampl = out[n-1];
 }
 
 //getter methods
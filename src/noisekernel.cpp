@@ -0,0 +1,237 @@
+/**
+ * @file noisekernel.cpp
+ * @brief NoiseKernel class implementation.
+ */
+
+#include "noisekernel.h"
+
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define NOISEKERNEL_X86
+#include <immintrin.h>
+#endif
+
+static const size_t kLanes = noiseState::kLanes;
+
+// float in [1, 2) from the upper 23 bits of a state
+static const uint32_t kOne = 0x3F800000u;
+
+static inline uint32_t
+xorshift(uint32_t x)
+{
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+// the lanes 0 to n - 1 for the last, incomplete group of a block
+static void
+process_tail(uint32_t *lane, float *out, float g2, bool mix, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        lane[i] = xorshift(lane[i]);
+        uint32_t bits = (lane[i] >> 9) | kOne;
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        // f - 1.5 is exact, so the multiplication is the only rounding
+        auto v = (f - 1.5f) * g2;
+        out[i] = mix ? out[i] + v : v;
+    }
+}
+
+static void
+process_scalar(uint32_t *lane, float *out, float g2, bool mix, size_t n)
+{
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes)
+        process_tail(lane, out + i, g2, mix, kLanes);
+    process_tail(lane, out + i, g2, mix, n - i);
+}
+
+#ifdef NOISEKERNEL_X86
+
+// Each lane depends on its own previous value, so a vector of lanes can only be updated every
+// few cycles. The kernels keep enough vectors of lanes in registers to hide that latency:
+// the groups of the block are walked once per pass of kPassLanes lanes.
+
+__attribute__((target("sse2")))
+static void
+process_sse2(uint32_t *lane, float *out, float g2, bool mix, size_t n)
+{
+    const size_t kPassLanes = 32;
+    const __m128i one = _mm_set1_epi32((int)kOne);
+    const __m128 vg2 = _mm_set1_ps(g2);
+    const __m128 half3 = _mm_set1_ps(1.5f);
+    auto groups = n / kLanes;
+
+    for (size_t pass = 0; pass < kLanes; pass += kPassLanes)
+    {
+        __m128i x[8];
+#pragma GCC unroll 8
+        for (size_t k = 0; k < 8; k++)
+            x[k] = _mm_loadu_si128((const __m128i *)(lane + pass + 4 * k));
+
+        for (size_t g = 0; g < groups; g++)
+        {
+            auto o = out + g * kLanes + pass;
+#pragma GCC unroll 8
+            for (size_t k = 0; k < 8; k++)
+            {
+                x[k] = _mm_xor_si128(x[k], _mm_slli_epi32(x[k], 13));
+                x[k] = _mm_xor_si128(x[k], _mm_srli_epi32(x[k], 17));
+                x[k] = _mm_xor_si128(x[k], _mm_slli_epi32(x[k], 5));
+                auto f = _mm_castsi128_ps(_mm_or_si128(_mm_srli_epi32(x[k], 9), one));
+                auto v = _mm_mul_ps(_mm_sub_ps(f, half3), vg2);
+                if (mix)
+                    v = _mm_add_ps(_mm_loadu_ps(o + 4 * k), v);
+                _mm_storeu_ps(o + 4 * k, v);
+            }
+        }
+
+#pragma GCC unroll 8
+        for (size_t k = 0; k < 8; k++)
+            _mm_storeu_si128((__m128i *)(lane + pass + 4 * k), x[k]);
+    }
+    process_tail(lane, out + groups * kLanes, g2, mix, n - groups * kLanes);
+}
+
+__attribute__((target("avx2")))
+static void
+process_avx2(uint32_t *lane, float *out, float g2, bool mix, size_t n)
+{
+    const __m256i one = _mm256_set1_epi32((int)kOne);
+    const __m256 vg2 = _mm256_set1_ps(g2);
+    const __m256 half3 = _mm256_set1_ps(1.5f);
+    auto groups = n / kLanes;
+
+    __m256i x[8];
+#pragma GCC unroll 8
+    for (size_t k = 0; k < 8; k++)
+        x[k] = _mm256_loadu_si256((const __m256i *)(lane + 8 * k));
+
+    for (size_t g = 0; g < groups; g++)
+    {
+        auto o = out + g * kLanes;
+#pragma GCC unroll 8
+        for (size_t k = 0; k < 8; k++)
+        {
+            x[k] = _mm256_xor_si256(x[k], _mm256_slli_epi32(x[k], 13));
+            x[k] = _mm256_xor_si256(x[k], _mm256_srli_epi32(x[k], 17));
+            x[k] = _mm256_xor_si256(x[k], _mm256_slli_epi32(x[k], 5));
+            auto f = _mm256_castsi256_ps(_mm256_or_si256(_mm256_srli_epi32(x[k], 9), one));
+            auto v = _mm256_mul_ps(_mm256_sub_ps(f, half3), vg2);
+            if (mix)
+                v = _mm256_add_ps(_mm256_loadu_ps(o + 8 * k), v);
+            _mm256_storeu_ps(o + 8 * k, v);
+        }
+    }
+
+#pragma GCC unroll 8
+    for (size_t k = 0; k < 8; k++)
+        _mm256_storeu_si256((__m256i *)(lane + 8 * k), x[k]);
+    // gcc does not clear the upper halves here; left dirty they slow down all following
+    // sse code of the thread, e.g. log2 of libm
+    _mm256_zeroupper();
+    process_tail(lane, out + groups * kLanes, g2, mix, n - groups * kLanes);
+}
+
+__attribute__((target("avx512f")))
+static void
+process_avx512(uint32_t *lane, float *out, float g2, bool mix, size_t n)
+{
+    const __m512i one = _mm512_set1_epi32((int)kOne);
+    const __m512 vg2 = _mm512_set1_ps(g2);
+    const __m512 half3 = _mm512_set1_ps(1.5f);
+    const __mmask16 all = 0xFFFF;
+    auto groups = n / kLanes;
+
+    __m512i x[4];
+#pragma GCC unroll 4
+    for (size_t k = 0; k < 4; k++)
+        x[k] = _mm512_loadu_si512(lane + 16 * k);
+
+    for (size_t g = 0; g < groups; g++)
+    {
+        auto o = out + g * kLanes;
+#pragma GCC unroll 4
+        for (size_t k = 0; k < 4; k++)
+        {
+            // the zero masked forms avoid a false uninitialized warning of gcc 12
+            x[k] = _mm512_xor_si512(x[k], _mm512_maskz_slli_epi32(all, x[k], 13));
+            x[k] = _mm512_xor_si512(x[k], _mm512_maskz_srli_epi32(all, x[k], 17));
+            x[k] = _mm512_xor_si512(x[k], _mm512_maskz_slli_epi32(all, x[k], 5));
+            auto f = _mm512_castsi512_ps(_mm512_or_si512(_mm512_maskz_srli_epi32(all, x[k], 9), one));
+            auto v = _mm512_mul_ps(_mm512_sub_ps(f, half3), vg2);
+            if (mix)
+                v = _mm512_add_ps(_mm512_loadu_ps(o + 16 * k), v);
+            _mm512_storeu_ps(o + 16 * k, v);
+        }
+    }
+
+#pragma GCC unroll 4
+    for (size_t k = 0; k < 4; k++)
+        _mm512_storeu_si512(lane + 16 * k, x[k]);
+    _mm256_zeroupper();
+    process_tail(lane, out + groups * kLanes, g2, mix, n - groups * kLanes);
+}
+
+#endif // NOISEKERNEL_X86
+
+static void
+process_isa(int isa, noiseState &state, float *out, float gain, bool mix, size_t n)
+{
+    auto g2 = 2.0f * gain;
+
+    switch (isa)
+    {
+#ifdef NOISEKERNEL_X86
+        case ISA_AVX512:
+            process_avx512(state.lane, out, g2, mix, n);
+            break;
+        case ISA_AVX2:
+            process_avx2(state.lane, out, g2, mix, n);
+            break;
+        case ISA_SSE2:
+            process_sse2(state.lane, out, g2, mix, n);
+            break;
+#endif
+        default:
+            process_scalar(state.lane, out, g2, mix, n);
+            break;
+    }
+}
+
+void
+NoiseKernel::Seed(noiseState &state, uint32_t seed)
+{
+    // every lane gets a well mixed, non zero state (murmur3 finalizer of seed and lane)
+    for (size_t k = 0; k < kLanes; k++)
+    {
+        uint32_t z = seed + 0x9E3779B9u * (uint32_t)(k + 1);
+        z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+        z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+        z ^= z >> 16;
+        state.lane[k] = (z != 0) ? z : 1;
+    }
+}
+
+void
+NoiseKernel::Process(noiseState &state, float *out, float gain, size_t n)
+{
+    process_isa(CpuIsa::Get(), state, out, gain, false, n);
+}
+
+void
+NoiseKernel::Mix(noiseState &state, float *out, float gain, size_t n)
+{
+    process_isa(CpuIsa::Get(), state, out, gain, true, n);
+}
+
+void
+NoiseKernel::ProcessWith(int isa, noiseState &state, float *out, float gain, size_t n)
+{
+    process_isa(isa, state, out, gain, false, n);
+}
@@ -1,13 +1,14 @@
 // OSCSynth Class
-// In this class all oscillators and filter obejcts are created
+// Connects the SynthEngine, which holds all oscillators and filter objects, to jack
 // Midi handling and OSC handling happens here
 // Callback function of the jack client is loaded with output buffers here as well
 
 #include "osc_synth.h"
 
+#include <jack/midiport.h>
 #include <aixlog.hpp>
 
-OSCSynth::OSCSynth() : JackCpp::AudioIO("OSCSynth", 0,1)
+OSCSynth::OSCSynth(size_t voices, size_t threads, bool direct, bool jack_midi) : JackCpp::AudioIO("OSCSynth", 0,1)
 {
 	reserveInPorts(2);
 	reserveOutPorts(2);
@@ -16,74 +17,58 @@ OSCSynth::OSCSynth() : JackCpp::AudioIO("OSCSynth", 0,1)
 	fs = getSampleRate();
 	// delivers the buffer size
 	nframes = getBufferSize();
-	// default gain
-	gain_ = 1.0;
 
 	ring_buffer_out_ = new JackCpp::RingBuffer<float>(nframes*8, true);
+	// jack midi events carry a frame of the current period, so they need the callback to render
+	direct_ = direct || jack_midi;
+	reported_overflows_ = 0;
+	reported_route_overflows_ = 0;
+	dropped_events_ = 0;
+	reported_dropped_ = 0;
+	period_time_ = MidiMan::now();
+	block_.resize(nframes);
 
 	LOG(INFO) << "fs: " << fs << " Hz.\n";
 	LOG(INFO) << "buffer size: " << nframes << " samples.\n";
+	LOG(INFO) << "rendering: " << (direct_ ? "in the jack callback" : "ring buffer") << ".\n";
+
+	// voices, modulation and effects, rendered in blocks of at most one period
+	engine_ = new SynthEngine(fs, nframes, voices, threads);
+	LOG(INFO) << "voices: " << engine_->GetVoices() << ".\n";
+	if (threads > 1)
+		LOG(INFO) << "render threads: " << std::min(threads, kMaxThreads) << ".\n";
+
+	// the engine has registered the parameters, the osc manager resolves addresses with them
+	osc = new OscMan("50000", &engine_->GetParams());
+	// midi comes from a jack port, read in the callback, or from the midi manager
+	midi = NULL;
+	midi_port_ = NULL;
+	if (jack_midi) {
+		midi_port_ = jack_port_register(client(), "midi_in", JACK_DEFAULT_MIDI_TYPE, JackPortIsInput, 0);
+		if (midi_port_ == NULL)
+			LOG(ERROR) << "could not register the jack midi port\n";
+		else
+			LOG(INFO) << "midi: jack port midi_in.\n";
+	}
+	else
+		// midi manager is created
+		midi = new MidiMan();
 
-	// Osclillator Containers for all available playable notes are created here
-	//osci = new Oscicontainer *[7];
-
-	// osci[0] = new Oscicontainer(fs);
-	// osci[1] = new Oscicontainer(fs);
-	// osci[2] = new Oscicontainer(fs);
-	// osci[3] = new Oscicontainer(fs);
-	// osci[4] = new Oscicontainer(fs);
-	// osci[5] = new Oscicontainer(fs);
-	// osci[6] = new Oscicontainer(fs);
-
-	osci.insert(std::make_pair(0, new Oscicontainer(fs)));
-	osci.insert(std::make_pair(1, new Oscicontainer(fs)));
-	osci.insert(std::make_pair(2, new Oscicontainer(fs)));
-	osci.insert(std::make_pair(3, new Oscicontainer(fs)));
-	osci.insert(std::make_pair(4, new Oscicontainer(fs)));
-	osci.insert(std::make_pair(5, new Oscicontainer(fs)));
-	osci.insert(std::make_pair(6, new Oscicontainer(fs)));
-
-	// osc manager is created
-	osc = new OscMan("50000");
-	// midi manager is created
-	midi = new MidiMan();
-
-	// the filter object is created
-	filter = new Biquad(0, 0.01, 0.2, 1.0);
-	// creates the lfo oscillator
-	lfo = new Oscicontainer(fs, 0, 1);
-	// disortion object is created
-	distortion = new Distortion();
-
-	filterStatus = false;
-	distortion_status_ = false;
-
-	midi->flushProcessedMessages();
-
-	t_tracking = 0;
-	counter = 0;
-
-	//vector to store the played Midi Value - the position within the vector corresponds to the oscillator number
-	Noten = {-1, -1, -1, -1, -1, -1, -1} ;
-	//vector containing the unused oscillators
-	freeOsci = { 6, 5, 4, 3, 2, 1, 0};
-	//vector to track the time of played notes - the position within the vector corresponds to the oscillator number
-	timetracker = { -1, -1, -1, -1, -1, -1, -1};
-    
-    //max number of oscillators
-	maxAnzahl_Osci = Noten.size();
-
-	valOld = 0.0;
-	typeOld = "";
-	pathOld = "";
-
-	setAllSineAmpl(1.0);
-
+#ifdef __OSCSYNTH_DEBUG__
+	// display midi messages
+	if (midi != NULL)
+		midi->setVerbose();
+#endif // __OSCSYNTH_DEBUG__
 }
 
 OSCSynth::~OSCSynth()
 {
 	ring_buffer_out_->~RingBuffer();
+	if (midi_port_ != NULL)
+		jack_port_unregister(client(), midi_port_);
+	delete osc;
+	delete midi;
+	delete engine_;
 }
 
 
@@ -98,8 +83,18 @@ OSCSynth::audioCallback(jack_nframes_t nframes,
 {
 	// Do nothing with input buffer
 	(void)inBufs;
-	// Read the ring buffer and write to the output buffer
-	ring_buffer_out_->read(outBufs[0], nframes);
+
+	if (direct_) {
+		// midi events of this period, each is applied at its frame
+		void *jack_midi = NULL;
+		if (midi_port_ != NULL)
+			jack_midi = jack_port_get_buffer(midi_port_, nframes);
+		// render the period straight into the output buffer
+		renderPeriod(outBufs[0], nframes, jack_midi);
+	}
+	else
+		// Read the ring buffer and write to the output buffer
+		ring_buffer_out_->read(outBufs[0], nframes);
 
  	///return 0 on success        
     return 0;
@@ -107,568 +102,163 @@ OSCSynth::audioCallback(jack_nframes_t nframes,
 
 
 // The Midi Handler receives messages from the midi manager
-// all note on and note off handling happens here
-void OSCSynth::midiHandler()
+// all note on and note off events are scheduled here, in the rendering thread
+void OSCSynth::midiHandler(size_t n, size_t reserve)
 {
-      	/// process midi messages
+	/// process midi messages
         
-        // In RT Midi defined values for note-on and note-off are being sent:
-        // val1 : 144 -> note on, 128 -> note off
-        //val2 : mote pitch from 0 bis 127 - > note pitch is being sent at both note-on and note-off
-        //val3 : velocity - when note on, value is between 0 and 126, note off: 127
-        
-		midiMessage info = midi->get_rtmidi();
-	
-		auto val1 = info.byte1;
-		auto val2 = info.byte2;
-		auto val3 = info.byte3;
-		auto delta_time = info.stamp; // get time information
-
-      	//accumulate time
-		t_tracking = t_tracking + delta_time; 
-       
-
-		size_t osci_nummer = 0;
-		size_t position = 0;
-		
-		///////////////////
-		// note-on procedure
-		///////////////////
-        if(val1 == 144)
-		{
-
-            //if all oscillators are being used, kill oldest
-            if(counter==7) {
-				auto min = timetracker[0];
-				size_t index = 0;
-				//find oldest value, i.e. smallest time value
-				for(size_t i = 1; i < timetracker.size(); i++)
-				{
-					if(timetracker[i] < min)
-					{
-						min = timetracker[i];
-						index = i;
-					}
-				}
-
-				//kill oldest oscillator
-
-				osci[index]->setReleaseNoteState(2);
-				osci[index]->setADSRState(4);
-				
-				//delete value in note vector
-				Noten[index] = -1;
-
-				//return free osci to according vector
-				freeOsci.push_back(index);
-				  
-				//delete time entry
-				timetracker[index] = -1;
-				   
-				counter--;
-			}
-
-			//formula to calculate the frequency from midi note value
-			auto f0 = std::pow(2.0, ((double)val2-69.0) / 12.0) * 440.0;
-				  
-			//find a free oscillator
-			osci_nummer = freeOsci.back();
-			
-				  
-			//make used osci unavailable
-			freeOsci.pop_back();
-			
-			osci[osci_nummer]->frequency(f0);
-				  
-				 
-			//hand amplitude and ADSR data to oscillator
-			osci[osci_nummer]->setReleaseNoteState(1);
-			osci[osci_nummer]->setADSRState(1);
-
-			//n set amplitude and phase
-			osci[osci_nummer]->amplitude(val3/126);
-			osci[osci_nummer]->phase(0);
-				  
-			//safe the played midi value
-			Noten[osci_nummer] = val2;
-				  
-			//safe the time instnace
-			timetracker[osci_nummer] = t_tracking;
-			
-				  
-			counter++;
-        }
-        
-        ///////////////////
-		// note-off procedure (val1 = 128)
-		///////////////////    
-        if(val1 == 128 )
-		{
-
-        	//find the oscillator that plays the frequency refering to the note-off order
-            position = find(Noten.begin(), Noten.end(), val2) - Noten.begin();
-            
-            
-            if(position < maxAnzahl_Osci) {	// security measure to prevent stack dump
-            	// enter into release mode
-              	osci[position]->setReleaseNoteState(2);
-              	osci[position]->setADSRState(4);
-              	
-              
-              	//delete array in notes vector
-              	Noten[position]= -1;
-              	//return freed oscillator
-              	freeOsci.insert(freeOsci.begin(),position);
-              
-                //delete time instance
-               	timetracker[position]= -1;
-               
-               	counter--;
-            }  
- 
-        }
-            
-#ifdef __OSCSYNTH_DEBUG__
-	if (val1 >= 0)
-		LOG(DEBUG) << "Free: " << freeOsci.size() << "\tTime: " << t_tracking << "\tCounter: " << counter << "\n";
-#endif // __OSCSYNTH_DEBUG__
-}
-
-
-// OSC Handler receives messegas from OSC manager and hands them over to Setters
-void OSCSynth::oscHandler() {
-
-  	auto val = 0.0;
-
-  	// determine the osc message type and use the according getter method 
-  	// (intiger = i, float= f, string =s)
-	auto type = osc->getLastType();
-	
-	if (type != "empty")
+	// In RT Midi defined values for note-on and note-off are being sent:
+	// status : 144 -> note on, 128 -> note off
+	// data1 : note pitch from 0 bis 127 - > note pitch is being sent at both note-on and note-off
+	// data2 : velocity - when note on, value is between 1 and 127, 0 is a note off as well
+
+	if (midi == NULL)
+		return;
+
+	// An event is placed in this period at the same distance from its start, as it arrived after
+	// the start of the last period. That delays all events by one period, but without jitter.
+	// The ring buffer renders ahead in bursts, so there all events start the period.
+	auto samples_per_us = fs * 1e-6;
+	auto last_time = period_time_;
+	period_time_ = MidiMan::now();
+
+	midiEvent events[kMidiBatch];
+	size_t count;
+
+	// a dense chord is taken in one go, every event in order,
+	// events which do not fit into the scheduler stay in the ring for the next period
+	auto places = [&]() {
+		auto free = engine_->GetFreeEvents();
+		return std::min((size_t)kMidiBatch, (free > reserve) ? free - reserve : 0);
+	};
+	while ((count = midi->drainEvents(events, places())) > 0)
 	{
-	  	if (type== "f")
-			val =  osc->getLastDouble();
-	  	else if (type== "i")
-			val =  osc->getLastInt();
-	  	else if  (type== "s")
-			val =  osc->getLastChar();
-
-	  	auto path = osc->getLastPath();
-
-		typeOld = type;
-		pathOld = path;
-		valOld = val;
-
-#ifdef __OSCSYNTH_DEBUG__
-	// display osc messages
-	LOG(DEBUG) << "/Val:" << val << "/Path:" << path << "/Type:" << type << "\n";
-#endif // __OSCSYNTH_DEBUG__
-
-		////////////////////////////////////////////////////////
-		// this section sends osc messages to according setters
-		///////////////////////////////////////////////////////
-		if (path.compare("/SineAmpl") == 0)
-			setAllSineAmpl(val);
-		else if (path.compare("/SawAmpl") == 0)
-			setAllSawAmpl(val);
-		else if (path.compare("/SquareAmpl") == 0)
-			setAllSquareAmpl(val);
-		else if (path.compare("/NoiseAmpl") == 0)
-			setAllNoiseAmpl(val);
-	    else if (path.compare("/LFO_Q") == 0)
-	      	filter->SetQ(val);
-		else if (path.compare("/Filter_Type") == 0)
-	      	filter->SetType((filterType)std::round(val));
-		else if (path.compare("/Filter_Gain") == 0)
-	      	filter->SetPeakGain(val);
-		else if (path.compare("/LFO_Freq") == 0)
-	    	lfo->frequency(val);
-	    else if (path.compare("/LFO_Type") == 0)
-	      	lfo->setLFOtype((int)val);
-		else if (path.compare("/Gain") == 0)
-	      	SetGain(val);
-		else if (path.compare("/Distortion_Drive") == 0)
-			distortion->SetDrive(val);
-		else if (path.compare("/Distortion_Range") == 0)
-			distortion->SetRange(val);
-		else if (path.compare("/Distortion_Blend") == 0)
-			distortion->SetBlend(val);
-		else if (path.compare("/Filter_Status") == 0)
-			filterStatus = (int)val;
-		else if (path.compare("/Distortion_Status") == 0)
-			distortion_status_ = (int)val;
-		else if (path.compare("/ADSR_Status") == 0)
-			setAllADSRStatus(val);
-		else if (path.compare("/ADSR_Sustain_Level") == 0)
-			setAllADSRSustainLevel(val);
-		else if (path.compare("/ADSR_Attack_Time") == 0)
-	    	setAllADSRAttackTime(val);
-		else if (path.compare("/ADSR_Release_Time") == 0)
-			setAllADSRReleaseTime(val);
-		else if (path.compare("/ADSR_Decay_Time") == 0)
-			setAllADSRDecayTime(val);
-		else if (path.compare("/Preset") == 0)
-			presets((int)std::round(val));
+		for (size_t i = 0; i < count; i++)
+		{
+			synthCommand cmd;
+			if (!SynthEngine::MidiToCommand(events[i].status, events[i].data1, events[i].data2, cmd))
+				continue;
+
+			auto frame = 0.0;
+			if (direct_)
+				frame = (int32_t)(events[i].time - last_time) * samples_per_us;
+			frame = std::max(0.0, std::min(frame, (double)n - 1.0));
+			schedule(frame, cmd);
+		}
 	}
-		
-	usleep(500);
 }
 
 
-// These functions help to make changes to all created note (osci)-objects
-
-void OSCSynth::setAllSineAmpl(double val) {
-
-	osci[0]->setSineAmpl(val);
-	osci[1]->setSineAmpl(val);
-	osci[2]->setSineAmpl(val);
-	osci[3]->setSineAmpl(val);
-	osci[4]->setSineAmpl(val);
-	osci[5]->setSineAmpl(val);
-	osci[6]->setSineAmpl(val);
-}
-
-void OSCSynth::setAllSawAmpl(double val){
-
-	osci[0]->setSawAmpl(val);
-	osci[1]->setSawAmpl(val);
-	osci[2]->setSawAmpl(val);
-	osci[3]->setSawAmpl(val);
-	osci[4]->setSawAmpl(val);
-	osci[5]->setSawAmpl(val);
-	osci[6]->setSawAmpl(val);
-}
-
-void OSCSynth::setAllSquareAmpl(double val) {
-
-	osci[0]->setSquareAmpl(val);
-	osci[1]->setSquareAmpl(val);
-	osci[2]->setSquareAmpl(val);
-	osci[3]->setSquareAmpl(val);
-	osci[4]->setSquareAmpl(val);
-	osci[5]->setSquareAmpl(val);
-	osci[6]->setSquareAmpl(val);
-}
-
-void OSCSynth::setAllNoiseAmpl(double val) {
-
-	val=val*0.5;
-	osci[0]->setNoiseAmpl(val);
-	osci[1]->setNoiseAmpl(val);
-	osci[2]->setNoiseAmpl(val);
-	osci[3]->setNoiseAmpl(val);
-	osci[4]->setNoiseAmpl(val);
-	osci[5]->setNoiseAmpl(val);
-	osci[6]->setNoiseAmpl(val);
+// Schedules an event in the engine, an event the full scheduler refuses is counted for reportOverflows
+void OSCSynth::schedule(double frame, const synthCommand &cmd)
+{
+	if (!engine_->Schedule(frame, cmd))
+		dropped_events_.fetch_add(1, std::memory_order_relaxed);
 }
 
-void OSCSynth::setAllADSRStatus(int val) {
 
-	if (val == 1) {
-		osci[0]->setADSRStatus(true);
-		osci[1]->setADSRStatus(true);
-		osci[2]->setADSRStatus(true);
-		osci[3]->setADSRStatus(true);
-		osci[4]->setADSRStatus(true);
-		osci[5]->setADSRStatus(true);
-		osci[6]->setADSRStatus(true);
-	}
-	else {
-		osci[0]->setADSRStatus(false);
-		osci[1]->setADSRStatus(false);
-		osci[2]->setADSRStatus(false);
-		osci[3]->setADSRStatus(false);
-		osci[4]->setADSRStatus(false);
-		osci[5]->setADSRStatus(false);
-		osci[6]->setADSRStatus(false);
+// Logs midi events, which were dropped because the ring of the midi manager was full,
+// osc routes, which were dropped because the queue of the osc manager was full,
+// and control events, which were dropped because the scheduler of the engine was full
+void OSCSynth::reportOverflows()
+{
+	auto dropped = dropped_events_.load(std::memory_order_relaxed);
+	if (dropped != reported_dropped_) {
+		LOG(WARNING) << "event scheduler full, " << dropped - reported_dropped_ << " events dropped ("
+					 << dropped << " in total)\n";
+		reported_dropped_ = dropped;
 	}
-}
-
-void OSCSynth::setAllADSRSustainLevel(double val) {
-
-	osci[0]->setADSRSustainLevel(val);
-	osci[1]->setADSRSustainLevel(val);
-	osci[2]->setADSRSustainLevel(val);
-	osci[3]->setADSRSustainLevel(val);
-	osci[4]->setADSRSustainLevel(val);
-	osci[5]->setADSRSustainLevel(val);
-	osci[6]->setADSRSustainLevel(val);
-}
 
-void OSCSynth::setAllADSRAttackTime(double val) {
-
-	osci[0]->setADSRAttackTime(val);
-	osci[1]->setADSRAttackTime(val);
-	osci[2]->setADSRAttackTime(val);
-	osci[3]->setADSRAttackTime(val);
-	osci[4]->setADSRAttackTime(val);
-	osci[5]->setADSRAttackTime(val);
-	osci[6]->setADSRAttackTime(val);
-}
+	auto route_overflows = osc->getRouteOverflows();
+	if (route_overflows != reported_route_overflows_) {
+		LOG(WARNING) << "osc route queue full, " << route_overflows - reported_route_overflows_ << " routes dropped ("
+					 << route_overflows << " in total)\n";
+		reported_route_overflows_ = route_overflows;
+	}
 
-void OSCSynth::setAllADSRReleaseTime(double val) {
+	if (midi == NULL)
+		return;
 
-	osci[0]->setADSRReleaseTime(val);
-	osci[1]->setADSRReleaseTime(val);
-	osci[2]->setADSRReleaseTime(val);
-	osci[3]->setADSRReleaseTime(val);
-	osci[4]->setADSRReleaseTime(val);
-	osci[5]->setADSRReleaseTime(val);
-	osci[6]->setADSRReleaseTime(val);
+	auto overflows = midi->getOverflows();
+	if (overflows != reported_overflows_) {
+		LOG(WARNING) << "midi ring full, " << overflows - reported_overflows_ << " events dropped ("
+					 << overflows << " in total)\n";
+		reported_overflows_ = overflows;
+	}
 }
 
 
-void OSCSynth::setAllADSRDecayTime(double val) {
-
-	osci[0]->setADSRDecayTime(val);
-	osci[1]->setADSRDecayTime(val);
-	osci[2]->setADSRDecayTime(val);
-	osci[3]->setADSRDecayTime(val);
-	osci[4]->setADSRDecayTime(val);
-	osci[5]->setADSRDecayTime(val);
-	osci[6]->setADSRDecayTime(val);
+// Sets all parameters of a preset, see presetnumber
+void OSCSynth::presets(int preset)
+{
+	engine_->SetPreset(preset);
 }
 
 
-
-//function that processes and scales the lfo-signal
-void OSCSynth::lfoHandler() {
-
-	//limits LFO Signal to certain step size
-	double lfo_step = 0.001;
-
-	//smallest value for Cutoff Frequency
-	double fc_min=200.0/fs;
-
-	//highest value for Cutoff Frequency
-	double fc_max=20000.0/fs;
-
-	//Get current LFO 
-	double lfo_value=lfo->getCurrentAmpl(); 
-
-
-	//scale from -1 to 1 in a way that the signal can oscillate between fc_max and fc_min
-	lfo_value=((fc_max-fc_min)/(1-(-1))) * (lfo_value -(-1)) + fc_min;
-
-	 
-	//no negative values - dirty workaround just in case amplitude should be higher than 1 for some reason
-	if (lfo_value<0) lfo_value=0;
-
-	//limits step size
-	if (lfo_value > (lfo_oldValue + lfo_step) || lfo_value < (lfo_oldValue - lfo_step) ) { 
-      
-		//change Cutoff of Filter when lfo_value changes
-    	filter->SetFc(lfo_value);
-
-
-      	lfo_oldValue=lfo_value;
-      
-	 }
-
+// loads a single cycle wav file as user waveform, see "/WaveAmpl"
+bool OSCSynth::loadWaveform(const char *path)
+{
+	return engine_->LoadWaveform(path);
 }
 
 
-void OSCSynth::presets(int preset) {
-
-	switch(preset) {
-
-		case wobble:
-
-			//oscillator settings
-			setAllSineAmpl(1);
-			setAllSquareAmpl(1);
-			setAllSawAmpl(1);
-			setAllNoiseAmpl(0);
-
-			//ADSR Settings
-			setAllADSRStatus(0);
-			/*setAllADSRAttackTime(1);
-			setAllADSRDecayTime(1);
-			setAllADSRReleaseTime(1);
-			setAllADSRSustainLevel(1);*/
-			
-			//Biquad settings
-			filterStatus = true;
-			filter->SetType(filterType::LOWSHELF);
-			//filter->setQ(1);
-			filter->SetPeakGain(100);
-
-			//lfo settings
-			lfo->setLFOtype(0);
-			lfo->frequency(2);
-
-			//gain (distortion) settings
-			distortion->SetDrive(3.0);
-
-
-		break;
-
-		case dreamy:
-
-			//oscillator settings
-			setAllSineAmpl(1);
-			setAllSquareAmpl(1);
-			setAllSawAmpl(0);
-			setAllNoiseAmpl(0);
-
-			//ADSR Settings
-			setAllADSRStatus(1);
-			setAllADSRAttackTime(20);
-			setAllADSRDecayTime(80);
-			setAllADSRSustainLevel(50);
-			setAllADSRReleaseTime(50);
-
-			
-			//Biquad settings
-			filterStatus = true;
-			filter->SetType(filterType::BANDPASS);
-			filter->SetQ(0.01);
-			//filter->setPeakGain(100);
-
-			//lfo settings
-			lfo->setLFOtype(0);
-			lfo->frequency(2);
-
-			//gain (distortion) settings
-			distortion->SetDrive(2.0);
-
-
-		break;
-
-
-		case nice_pulse:
-
-			//oscillator settings
-			setAllSineAmpl(1);
-			setAllSquareAmpl(1);
-			setAllSawAmpl(1);
-			setAllNoiseAmpl(0);
-
-			//ADSR Settings
-			setAllADSRStatus(1);
-			setAllADSRAttackTime(30);
-			setAllADSRDecayTime(30);
-			setAllADSRSustainLevel(50);
-			setAllADSRReleaseTime(50);
-
-			
-			//Biquad settings
-			filterStatus = true;
-			filter->SetType(filterType::HIGHSHELF);
-			//filter->setQ(0.01);
-			filter->SetPeakGain(15);
-
-			//lfo settings
-			lfo->setLFOtype(2);
-			lfo->frequency(5);
-
-			//gain (distortion) settings
-			distortion->SetDrive(5.0);
-
-
-		break;
-
-
-		case in_the_night:
-
-			//oscillator settings
-			setAllSineAmpl(0);
-			setAllSquareAmpl(1);
-			setAllSawAmpl(1);
-			setAllNoiseAmpl(0);
-
-			//ADSR Settings
-			setAllADSRStatus(1);
-			setAllADSRAttackTime(3);
-			setAllADSRDecayTime(15);
-			setAllADSRSustainLevel(70);
-			setAllADSRReleaseTime(30);
-
-			
-			//Biquad settings
-			filterStatus = true;
-			filter->SetType(filterType::LOWPASS);
-			filter->SetQ(0.5);
-			//filter->setPeakGain(15);
-
-			//lfo settings
-			lfo->setLFOtype(1);
-			lfo->frequency(3);
-
-			//gain (distortion) settings
-			distortion->SetDrive(5.0);
-
-
-		break;
-
-
-		case high_hat:
-
-			//oscillator settings
-			setAllSineAmpl(1);
-			setAllSquareAmpl(1);
-			setAllSawAmpl(1);
-			setAllNoiseAmpl(1);
-
-			//ADSR Settings
-			setAllADSRStatus(0);
-			/*setAllADSRAttackTime(3);
-			setAllADSRDecayTime(15);
-			setAllADSRSustainLevel(70);
-			setAllADSRReleaseTime(30);*/
-
-			
-			//Biquad settings
-			filterStatus = true;
-			filter->SetType(filterType::HIGHPASS);
-			filter->SetQ(0.09);
-			//filter->setPeakGain(15);
-
-			//lfo settings
-			lfo->setLFOtype(1);
-			lfo->frequency(8);
-
-			//gain (distortion) settings
-			distortion->SetDrive(3.0);
-
-
-		break;
+// Renders one period: schedules the control events in the engine, which renders the voices,
+// the modulation and the effects
+void
+OSCSynth::renderPeriod(float *out, size_t n, void *jack_midi)
+{
+	// osc: the latest value of every changed parameter, however many messages arrived,
+	// at the start of the period
+	synthCommand osc_cmds[PARAM_COUNT];
+	auto osc_count = osc->drainCommands(osc_cmds);
+	for (size_t i = 0; i < osc_count; i++)
+		schedule(0.0, osc_cmds[i]);
+
+	// osc: new modulation routes, those without a place in the scheduler wait for the next period
+	synthCommand route_cmds[kRouteBatch];
+	auto route_count = osc->drainRoutes(route_cmds, std::min((size_t)kRouteBatch, engine_->GetFreeEvents()));
+	for (size_t i = 0; i < route_count; i++)
+		schedule(0.0, route_cmds[i]);
+
+	// jack midi events cannot wait for the next period, so the RtMidi events
+	// leave enough places for them
+	uint32_t jack_count = 0;
+	if (jack_midi != NULL)
+		jack_count = jack_midi_get_event_count(jack_midi);
+
+	// RtMidi: at the time they arrived
+	midiHandler(n, jack_count);
+
+	// jack midi: at their frame
+	if (jack_midi != NULL)
+	{
+		for (uint32_t i = 0; i < jack_count; i++)
+		{
+			jack_midi_event_t ev;
+			if (jack_midi_event_get(&ev, jack_midi, i) != 0 || ev.size < 1 || ev.size > 3)
+				continue;
 
+			synthCommand cmd;
+			if (SynthEngine::MidiToCommand(ev.buffer[0], (ev.size > 1) ? ev.buffer[1] : 0, (ev.size > 2) ? ev.buffer[2] : 0, cmd))
+				schedule(std::min((double)ev.time, (double)n - 1.0), cmd);
+		}
 	}
+
+	engine_->Render(out, n);
 }
 
 void
 OSCSynth::process()
 {
-	for(size_t i = 0; i < 1; i++)
+	// in direct mode the jack callback renders
+	if (direct_)
+		return;
+
+	// render whole jack periods as long as the ring buffer has space for them
+	while (ring_buffer_out_->getWriteSpace() >= nframes)
 	{
-		size_t dataSize = ring_buffer_out_->getWriteSpace();
-		std::vector<float> data;
-    	for(size_t frameCNT = 0; frameCNT  < dataSize; frameCNT++)
-		{
-			auto sample = 		osci[0]->getNextSample() +
-								osci[1]->getNextSample() +
-								osci[2]->getNextSample() +
-								osci[3]->getNextSample() +
-								osci[4]->getNextSample() +
-								osci[5]->getNextSample() +
-								osci[6]->getNextSample();
-
-			sample = sample / 7.0 * gain_;
-			
-			// apply filter
-			if(filterStatus)
-				sample = filter->Process(sample);
-		
-			// apply distortion
-			if (distortion_status_)
-				sample = distortion->Process(sample); 
-
-			// rotate lfo oscillator to next step
-			lfo->getNextSample();
-
-			data.push_back((float)sample);
-		}
-		ring_buffer_out_->write(data.data(), dataSize);
-    }
-}
\ No newline at end of file
+		float *data = block_.data();
+		renderPeriod(data, nframes);
+		ring_buffer_out_->write(data, nframes);
+	}
+}
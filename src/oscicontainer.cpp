@@ -12,6 +12,12 @@ Oscicontainer::Oscicontainer(uint32_t fs)
 	osciSquare = new Squarewave(440,0.0,0,fs_);
 	osciNoise = new Noise(0.0);
 
+  // band-limited wavetable oscillators, off by default
+  wtSine = new WavetableOsc(&Wavetable::GetShape(SHAPE_SINE),440,0.0,0,fs_);
+  wtSaw = new WavetableOsc(&Wavetable::GetShape(SHAPE_SAW),440,0.0,0,fs_);
+  wtSquare = new WavetableOsc(&Wavetable::GetShape(SHAPE_SQUARE),440,0.0,0,fs_);
+  wavetableStatus = false;
+
   // set lfo status to false -> this is the signal container
   // for the audible signals not lfo
 	isLFO = false;
@@ -21,6 +27,7 @@ Oscicontainer::Oscicontainer(uint32_t fs)
 
   // create adsr object for envelope
   envelope = new ADSR();
+  envelope->SetSampleRate(fs);
   // default is: adsr off
   ADSRStatus = false;
 
@@ -39,9 +46,9 @@ Oscicontainer::Oscicontainer(uint32_t fs, int type, double f)
 {
   fs_ = fs;
   // initialize lfo signals with preset values
-  lfoSaw = new Sawtoothwave(f,1,0,48000);
-  lfoSquare = new Squarewave(f,1,0,48000);
-  lfoSin = new Sinusoid(f,1,0,48000);
+  lfoSaw = new Sawtoothwave(f,1,0,fs);
+  lfoSquare = new Squarewave(f,1,0,fs);
+  lfoSin = new Sinusoid(f,1,0,fs);
   
   // presets for different lfo signals
   if(type ==1) {
@@ -62,6 +69,7 @@ Oscicontainer::Oscicontainer(uint32_t fs, int type, double f)
   // set isLFO true, because this container is the lfo signal
   // container
   isLFO = true;
+  wavetableStatus = false;
 }
 
 
@@ -82,9 +90,15 @@ double Oscicontainer::getNextSample() {
   // audible signal
 	} else {
     // add up all amplitudes
-    thisVal = osciSine->getNextSample();
-    thisVal = thisVal + osciSaw->getNextSample();
-    thisVal = thisVal + osciSquare->getNextSample();
+    if (wavetableStatus) {
+      thisVal = wtSine->getNextSample();
+      thisVal = thisVal + wtSaw->getNextSample();
+      thisVal = thisVal + wtSquare->getNextSample();
+    } else {
+      thisVal = osciSine->getNextSample();
+      thisVal = thisVal + osciSaw->getNextSample();
+      thisVal = thisVal + osciSquare->getNextSample();
+    }
     thisVal = thisVal + osciNoise->getNextSample();
     // if adsr is activated, multiply envelope and signal
     if (ADSRStatus) {
@@ -97,6 +111,54 @@ double Oscicontainer::getNextSample() {
 
 }
 
+/* the renderBlock Methode renders the next n samples
+ * of the container into out. The decision between lfo, lfo type
+ * and envelope is made once per block, not once per sample
+ */
+void Oscicontainer::renderBlock(float *out, size_t n) {
+  // lfo signal
+  if (isLFO==true) {
+    if(type ==1) lfoSaw->renderBlock(out, n);
+    else if (type ==2) lfoSquare->renderBlock(out, n);
+    else lfoSin->renderBlock(out, n);
+
+  // audible signal, rendered in chunks of the scratch buffer size
+  } else {
+    float tmp[64];
+    size_t done = 0;
+    while (done < n) {
+      size_t m = n - done;
+      if (m > 64) m = 64;
+      float *o = out + done;
+
+      // add up all amplitudes
+      if (wavetableStatus) {
+        wtSine->renderBlock(o, m);
+        wtSaw->renderBlock(tmp, m);
+        for (size_t i = 0; i < m; i++) o[i] += tmp[i];
+        wtSquare->renderBlock(tmp, m);
+        for (size_t i = 0; i < m; i++) o[i] += tmp[i];
+      } else {
+        osciSine->renderBlock(o, m);
+        osciSaw->renderBlock(tmp, m);
+        for (size_t i = 0; i < m; i++) o[i] += tmp[i];
+        osciSquare->renderBlock(tmp, m);
+        for (size_t i = 0; i < m; i++) o[i] += tmp[i];
+      }
+      osciNoise->renderBlock(tmp, m);
+      for (size_t i = 0; i < m; i++) o[i] += tmp[i];
+
+      // if adsr is activated, multiply envelope and signal
+      if (ADSRStatus)
+        envelope->ProcessBlock(o, m);
+      else
+        relNote->processBlock(o, m);
+
+      done += m;
+    }
+  }
+}
+
 /* set signal amplitudes for the complete
  * lfo container or the complete
  * audible signal container
@@ -124,6 +186,9 @@ void Oscicontainer::amplitude(double a) {
     osciSquare->amplitude(osciSquareAmpl*a);
     osciNoise->amplitude(osciNoiseAmpl*a);
     osciSine->amplitude(osciSineAmpl*a);
+    wtSaw->amplitude(osciSawAmpl*a);
+    wtSquare->amplitude(osciSquareAmpl*a);
+    wtSine->amplitude(osciSineAmpl*a);
 	}
 }
 
@@ -143,6 +208,9 @@ void Oscicontainer::frequency(double f) {
     osciSaw->frequency(f);
     osciSquare->frequency(f);
     osciSine->frequency(f);
+    wtSaw->frequency(f);
+    wtSquare->frequency(f);
+    wtSine->frequency(f);
 	}
 }
 
@@ -153,6 +221,9 @@ void Oscicontainer::phase(double phi) {
 	osciSaw->phase(phi);
 	osciSquare->phase(phi);
 	osciSine->phase(phi);
+	wtSaw->phase(phi);
+	wtSquare->phase(phi);
+	wtSine->phase(phi);
 }
 
 /* set sinewave amplitude
@@ -257,4 +328,11 @@ void Oscicontainer::setADSRSustainLevel(float level) {
  */
 void Oscicontainer::setADSRReleaseTime(float t) {
   envelope->SetRelease(t);
-}
\ No newline at end of file
+}
+
+/* use the band-limited wavetables instead of the
+ * naive sine, saw and square generators
+ */
+void Oscicontainer::setWavetableStatus(bool status) {
+  wavetableStatus = status;
+}
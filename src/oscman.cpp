@@ -1,6 +1,6 @@
 #include "oscman.h"
-#include <fstream>
-#include <string>
+#include "modmatrix.h"
+#include <string.h>
 #include <aixlog.hpp>
 
 /* Error handler
@@ -15,18 +15,28 @@ error(int num, const char *msg, const char *path)
 /* Constructor
  * initialize and start osc server thread
  */
-OscMan::OscMan()
+OscMan::OscMan(const ParamRegistry *registry)
+    : registry(registry), routes(kRouteQueueSize)
 {
     init("50000");
 }
 
-OscMan::OscMan(const char* port)
+OscMan::OscMan(const char* port, const ParamRegistry *registry)
+    : registry(registry), routes(kRouteQueueSize)
 {
     init(port);
 }
 
+/* Destructor
+ * stop and free osc server thread
+ */
+OscMan::~OscMan()
+{
+    lo_server_thread_free(st);
+}
+
 /* Callback Handler
- * process osc messages
+ * process osc messages, no allocations, the value is stored in the slot of its parameter
  */
 int
 OscMan::double_callback(    const char *path,
@@ -37,110 +47,146 @@ OscMan::double_callback(    const char *path,
                             void *user_data )
 {
     // Unused parameter
-    (void)argc;
     (void)data;
 
     // Converts between types using a combination of implicit and user-defined conversions
     auto statCast = static_cast<OscMan*>(user_data);
+    statCast->messages.fetch_add(1, std::memory_order_relaxed);
 
-    // message double (float)
-    if (std::string(types)=="f")
-    {
-    	dMess tmpD;
-      	tmpD.type = types;
-      	tmpD.path = path; 
-      	tmpD.val = argv[0]->f;
-      	statCast->dMessages.push_back(tmpD);
-    // message integer
-    }
-    else if (std::string(types)=="i")
-    {
-        iMess tmp;
-        tmp.type = types;
-        tmp.path = path;
-        tmp.val = argv[0]->i;
-        statCast->iMessages.push_back(tmp);
-    // message char
-    }
-    else if (std::string(types)=="s")
+    if (strcmp(path, "/ModRoute") == 0)
+        return route_callback(statCast, types, argv, argc);
+
+    // message double (float), integer or char (ASCII recalculation)
+    double val = 0.0;
+    if (argc > 0 && types[0] == 'f')
+        val = argv[0]->f;
+    else if (argc > 0 && types[0] == 'i')
+        val = argv[0]->i;
+    else if (argc > 0 && types[0] == 's')
+        val = (double)argv[0]->s - 48;
+
+#ifdef __OSCSYNTH_DEBUG__
+    // display osc messages
+    LOG(DEBUG) << "/Val:" << val << "/Path:" << path << "/Type:" << types << "\n";
+#endif // __OSCSYNTH_DEBUG__
+
+    // the address is resolved here, the rendering thread only gets the id
+    auto param = statCast->registry->Find(path);
+    if (param < 0 || param >= PARAM_COUNT)
     {
-        sMess tmps;
-        tmps.type = types;
-        tmps.path = path;
-        tmps.val = argv[0]->s;
-        statCast->sMessages.push_back(tmps);
+        statCast->unknownPaths.fetch_add(1, std::memory_order_relaxed);
+        return 1;
     }
 
-    // store all information
-    statCast->paths.push_back(path);
-    statCast->types.push_back(types);  
-    //statCast->messages.push_back(argv[0]->f);
-
+    // the value first, the release of the mask publishes it
+    uint64_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+    statCast->slotValue[param].store(bits, std::memory_order_relaxed);
+    statCast->dirtyMask.fetch_or((uint64_t)1 << param, std::memory_order_release);
     return 1;
 }
 
-/* get last double value from double value vector
+/* Route Handler
+ * "/ModRoute source param depth", param is an OSC address or a parameter id,
+ * a message with invalid arguments counts as an unknown path
  */
-double OscMan::getLastDouble() {
-	if(dMessages.size()>0) {
-	    dMess tmp = dMessages[0];
-	    dMessages.clear();
-		return tmp.val;
-	} else
-      	return 0.0;
-}
+int
+OscMan::route_callback(OscMan *osc, const char *types, lo_arg **argv, int argc)
+{
+    auto number = [&](int i, double &val) {
+        if (types[i] == 'f')
+            val = argv[i]->f;
+        else if (types[i] == 'i')
+            val = argv[i]->i;
+        else
+            return false;
+        return true;
+    };
 
-/* get last integer value from integer value vector
- */
-double OscMan::getLastInt() {
-	iMess tmp = iMessages[0];
-	iMessages.clear();
-    return (double)tmp.val;
-}
+    double source, param, depth;
+    auto valid = argc == 3 && number(0, source) && number(2, depth);
+    if (valid && types[1] == 's')
+        param = osc->registry->Find(&argv[1]->s);
+    else
+        valid = valid && number(1, param);
 
-/* get last char value from char value vector
- */
-double OscMan::getLastChar() { 
-    if(sMessages.size()>0) {
-        sMess tmp = sMessages[0];
-        sMessages.clear();
-        //ASCII recalculation
-        return (double)tmp.val-48;
-    } else
-        return 0.0;
+    if (!valid || source < 0 || source >= MOD_SRC_COUNT || param < 0 || param >= PARAM_COUNT)
+    {
+        osc->unknownPaths.fetch_add(1, std::memory_order_relaxed);
+        return 1;
+    }
+
+    synthCommand cmd;
+    cmd.type = CMD_MOD_ROUTE;
+    cmd.id = (int32_t)source * PARAM_COUNT + (int32_t)param;
+    cmd.value = depth;
+    // a full queue counts the message, see getRouteOverflows
+    osc->routes.Push(cmd);
+    return 1;
 }
 
-/* get last osc message path
+/* Drain
+ * take all changed parameters, a value written after the mask was taken
+ * is delivered now and once more with the next call
  */
-std::string OscMan::getLastPath() {
-    if(paths.size()>0) {
-        std::string s = paths[0];
-        paths.clear();
-        return s;
-    } else
-        return "No messages received!";
+size_t
+OscMan::drainCommands(synthCommand *cmds)
+{
+    auto mask = dirtyMask.exchange(0, std::memory_order_acquire);
+    size_t n = 0;
+
+    // a preset sets many parameters, so it goes first
+    if (mask & ((uint64_t)1 << PARAM_PRESET))
+    {
+        mask &= ~((uint64_t)1 << PARAM_PRESET);
+        n = 1;
+        cmds[0].type = CMD_PARAM;
+        cmds[0].id = PARAM_PRESET;
+        auto bits = slotValue[PARAM_PRESET].load(std::memory_order_relaxed);
+        memcpy(&cmds[0].value, &bits, sizeof(bits));
+    }
+
+    for (int param = 0; mask != 0; param++, mask >>= 1)
+    {
+        if (!(mask & 1))
+            continue;
+
+        cmds[n].type = CMD_PARAM;
+        cmds[n].id = param;
+        auto bits = slotValue[param].load(std::memory_order_relaxed);
+        memcpy(&cmds[n].value, &bits, sizeof(bits));
+        n++;
+    }
+
+    return n;
 }
 
-/* get last osc message type
- */
-std::string OscMan::getLastType() {
-    if(types.size()>0) {
-        std::string s = types[0];
-        types.clear();
-        return s;
-    } else
-        return "empty";
+size_t
+OscMan::drainRoutes(synthCommand *cmds, size_t max)
+{
+    size_t n = 0;
+    while (n < max && routes.Pop(cmds[n]))
+        n++;
+    return n;
 }
 
 // PRIVATE
 void
 OscMan::init(const char* port)
 {
+    static_assert(PARAM_COUNT <= 64, "the dirty mask has one bit per parameter");
+
+    for (auto &slot : slotValue)
+        slot.store(0, std::memory_order_relaxed);
+    dirtyMask.store(0, std::memory_order_relaxed);
+    messages.store(0, std::memory_order_relaxed);
+    unknownPaths.store(0, std::memory_order_relaxed);
+
     // osc server thread object
-	lo_server_thread st = lo_server_thread_new(port, error);
+	st = lo_server_thread_new(port, error);
     // Add the callback handler to the server!
 	lo_server_thread_add_method(st, NULL, NULL, double_callback, this);
 	// start server thread
     lo_server_thread_start(st);
     LOG(INFO) << "Started OSC Server!\n";
-}
\ No newline at end of file
+}
@@ -0,0 +1,195 @@
+/**
+ * @file oversampler.cpp
+ * @brief Oversampler and HalfbandStage class implementation.
+ */
+
+#include "oversampler.h"
+
+#include "firkernel.h"
+
+#include <math.h>
+#include <string.h>
+
+// length of the steps in eighths of the first one, starting next to the base rate
+static const size_t kStageEighths[Oversampler::kMaxStages] = {8, 5, 4};
+static const double kKaiserBeta = 8.0;
+
+// modified bessel function of the first kind, order 0
+static double
+bessel_i0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 32; k++)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+HalfbandStage::HalfbandStage(size_t half_taps, size_t max_block)
+{
+    half_taps_ = half_taps;
+
+    // h[k] for the odd k from -(2M - 1) to 2M - 1, the center is 0.5 and the even ones are 0
+    auto m = (int)half_taps_;
+    auto half_len = 2.0 * m - 1.0;
+    coeffs_.resize(2 * half_taps_);
+    double sum = 0.0;
+    for (int t = 0; t < 2 * m; t++)
+    {
+        auto k = 2 * t - 2 * m + 1;
+        auto r = k / half_len;
+        auto window = bessel_i0(kKaiserBeta * sqrt(1.0 - r * r)) / bessel_i0(kKaiserBeta);
+        auto h = sin(M_PI * k / 2.0) / (M_PI * k) * window;
+        coeffs_[t] = (float)h;
+        sum += h;
+    }
+    // the side coefficients add up to 0.5, so the gain at dc is exactly 1
+    for (auto &c : coeffs_)
+        c = (float)(c * 0.5 / sum);
+
+    up_buf_.assign(2 * half_taps_ - 1 + max_block, 0.0f);
+    even_buf_.assign(2 * half_taps_ - 1 + max_block, 0.0f);
+    odd_buf_.assign(half_taps_ + max_block, 0.0f);
+    acc_.assign(max_block, 0.0f);
+}
+
+HalfbandStage::~HalfbandStage()
+{
+}
+
+void
+HalfbandStage::Up(const float *in, float *out, size_t n)
+{
+    auto hist = 2 * half_taps_ - 1;
+    auto taps = 2 * half_taps_;
+    auto c = coeffs_.data();
+    auto b = up_buf_.data();
+
+    auto acc = acc_.data();
+
+    // the phase with the side coefficients
+    memcpy(b + hist, in, n * sizeof(float));
+    FirKernel::Process(c, taps, b, acc, n);
+
+    // doubled, the zeros in between carry no energy, then the phase with the center one,
+    // the input delayed by M - 1 samples
+    for (size_t i = 0; i < n; i++)
+    {
+        out[2 * i] = 2.0f * acc[i];
+        out[2 * i + 1] = b[i + half_taps_];
+    }
+    memmove(b, b + n, hist * sizeof(float));
+}
+
+void
+HalfbandStage::Down(const float *in, float *out, size_t n)
+{
+    auto hist = 2 * half_taps_ - 1;
+    auto taps = 2 * half_taps_;
+    auto c = coeffs_.data();
+    auto e = even_buf_.data();
+    auto o = odd_buf_.data();
+
+    for (size_t i = 0; i < n; i++)
+    {
+        e[hist + i] = in[2 * i];
+        o[half_taps_ + i] = in[2 * i + 1];
+    }
+    // the even inputs meet the side coefficients, the odd ones the center one
+    FirKernel::Process(c, taps, e, out, n);
+    for (size_t i = 0; i < n; i++)
+        out[i] += 0.5f * o[i];
+    memmove(e, e + n, hist * sizeof(float));
+    memmove(o, o + n, half_taps_ * sizeof(float));
+}
+
+void
+HalfbandStage::Reset()
+{
+    memset(up_buf_.data(), 0, up_buf_.size() * sizeof(float));
+    memset(even_buf_.data(), 0, even_buf_.size() * sizeof(float));
+    memset(odd_buf_.data(), 0, odd_buf_.size() * sizeof(float));
+}
+
+Oversampler::Oversampler(size_t max_block, size_t half_taps)
+{
+    stages_ = 0;
+    max_block_ = max_block;
+    for (size_t s = 0; s < kMaxStages; s++)
+    {
+        // step s runs from 2^s to 2^(s + 1) times the base rate
+        auto block = max_block << s;
+        auto stage_half_taps = (half_taps * kStageEighths[s] + 7) / 8;
+        if (stage_half_taps < kMinHalfTaps)
+            stage_half_taps = kMinHalfTaps;
+        stage_.push_back(HalfbandStage(stage_half_taps, block));
+        buf_[s].assign(2 * block, 0.0f);
+    }
+}
+
+Oversampler::~Oversampler()
+{
+}
+
+float *
+Oversampler::Up(const float *in, size_t n)
+{
+    if (stages_ == 0)
+    {
+        memcpy(buf_[0].data(), in, n * sizeof(float));
+        return buf_[0].data();
+    }
+
+    stage_[0].Up(in, buf_[0].data(), n);
+    for (size_t s = 1; s < stages_; s++)
+        stage_[s].Up(buf_[s - 1].data(), buf_[s].data(), n << s);
+    return buf_[stages_ - 1].data();
+}
+
+void
+Oversampler::Down(float *out, size_t n)
+{
+    if (stages_ == 0)
+    {
+        memcpy(out, buf_[0].data(), n * sizeof(float));
+        return;
+    }
+
+    for (size_t s = stages_ - 1; s > 0; s--)
+        stage_[s].Down(buf_[s].data(), buf_[s - 1].data(), n << s);
+    stage_[0].Down(buf_[0].data(), out, n);
+}
+
+void
+Oversampler::Reset()
+{
+    for (auto &stage : stage_)
+        stage.Reset();
+}
+
+double
+Oversampler::GetLatency()
+{
+    // step s delays by its latency in samples of 2^s times the base rate
+    double latency = 0.0;
+    for (size_t s = 0; s < stages_; s++)
+        latency += (double)stage_[s].GetLatency() / (double)((size_t)1 << s);
+    return latency;
+}
+
+void
+Oversampler::SetFactor(size_t factor)
+{
+    size_t stages = 0;
+    while (stages < kMaxStages && ((size_t)2 << stages) <= factor)
+        stages++;
+
+    if (stages != stages_)
+    {
+        stages_ = stages;
+        Reset();
+    }
+}
@@ -0,0 +1,104 @@
+/**
+ * @file paramregistry.cpp
+ * @brief ParamRegistry class implementation.
+ */
+
+#include "paramregistry.h"
+
+#include <string.h>
+
+ParamRegistry::ParamRegistry()
+{
+    mask_ = 0;
+    seed_ = 0;
+    table_.assign(1, -1);
+}
+
+ParamRegistry::~ParamRegistry()
+{
+}
+
+void
+ParamRegistry::Add(const char *path, int id, paramSetter setter)
+{
+    if (id < 0)
+        return;
+
+    if ((size_t)id >= paths_.size())
+    {
+        paths_.resize(id + 1, NULL);
+        setters_.resize(id + 1, NULL);
+    }
+    paths_[id] = path;
+    setters_[id] = setter;
+    ids_.push_back(id);
+}
+
+void
+ParamRegistry::Build()
+{
+    // at least twice as many slots as addresses, so a seed is found after a few tries
+    size_t size = 1;
+    while (size < 2 * ids_.size())
+        size <<= 1;
+
+    for (;;)
+    {
+        mask_ = (uint32_t)(size - 1);
+        for (seed_ = 0; seed_ < 1000; seed_++)
+        {
+            table_.assign(size, -1);
+            bool collision = false;
+            for (auto id : ids_)
+            {
+                auto &slot = table_[hash(paths_[id], seed_) & mask_];
+                if (slot >= 0)
+                {
+                    collision = true;
+                    break;
+                }
+                slot = id;
+            }
+            if (!collision)
+                return;
+        }
+        size <<= 1;
+    }
+}
+
+int
+ParamRegistry::Find(const char *path) const
+{
+    auto id = table_[hash(path, seed_) & mask_];
+    if (id < 0 || strcmp(paths_[id], path) != 0)
+        return -1;
+    return id;
+}
+
+void
+ParamRegistry::Set(SynthEngine *synth, int id, double value) const
+{
+    if (id >= 0 && (size_t)id < setters_.size() && setters_[id] != NULL)
+        setters_[id](synth, value);
+}
+
+const char *
+ParamRegistry::GetPath(int id) const
+{
+    if (id < 0 || (size_t)id >= paths_.size())
+        return NULL;
+    return paths_[id];
+}
+
+uint32_t
+ParamRegistry::hash(const char *path, uint32_t seed)
+{
+    uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (; *path; path++)
+    {
+        h ^= (uint8_t)*path;
+        h *= 16777619u;
+    }
+    // the low bits select the slot, so fold the high bits in
+    return h ^ (h >> 15);
+}
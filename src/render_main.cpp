@@ -0,0 +1,276 @@
+// Entry point of oscsynth-render
+// Renders a Standard MIDI File and an optional OSC parameter script into a wav file,
+// without jack and as fast as the cpu allows, and prints the realtime factor
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <aixlog.hpp>
+
+#include "midifile.h"
+#include "synthengine.h"
+
+// A parameter change of the script
+struct scriptEvent
+{
+	double time; // seconds from the start
+	synthCommand cmd;
+};
+
+// Command line help
+void printUsage(const char *name)
+{
+	std::cout << "Usage: " << name << " [options] input.mid output.wav\n"
+			  << "  -s, --script FILE    osc parameter script, one \"<seconds> <address> <value>\" per line\n"
+			  << "  -r, --rate N         sample rate in Hz (default 48000)\n"
+			  << "  -b, --block N        samples per rendered block (default 256)\n"
+			  << "  -v, --voices N       polyphony, 1 to " << SynthEngine::kMaxVoices << " (default 7)\n"
+			  << "  -t, --threads N      cores rendering the voices, 1 to " << SynthEngine::kMaxThreads << " (default 1)\n"
+			  << "  -T, --tail SECONDS   rendered after the end of the file, for the releases (default 2)\n"
+			  << "  -w, --waveform FILE  single cycle wav file for the user waveform (/WaveAmpl)\n"
+			  << "  -h, --help           show this help\n"
+			  << "Midi messages of every channel are played, the script is applied before midi\n"
+			  << "messages at the same time. Lines of the script starting with # are comments.\n"
+			  << "A line \"<seconds> /ModRoute <source> <address> <depth>\" adds a modulation route.\n";
+}
+
+// Reads the parameter script, the osc addresses are resolved with the registry of the engine
+bool readScript(const char *path, const ParamRegistry &params, std::vector<scriptEvent> &events)
+{
+	std::ifstream file(path);
+	if (!file) {
+		std::cerr << "could not open " << path << "\n";
+		return false;
+	}
+
+	std::string line;
+	for (size_t number = 1; std::getline(file, line); number++) {
+		std::istringstream fields(line);
+		std::string first;
+		if (!(fields >> first) || first[0] == '#')
+			continue;
+
+		scriptEvent ev;
+		std::string address;
+		char *end;
+		ev.time = strtod(first.c_str(), &end);
+		if (*end != '\0' || !(fields >> address) || ev.time < 0.0) {
+			std::cerr << path << ":" << number << ": expected <seconds> <address> <value>\n";
+			return false;
+		}
+
+		// a modulation route: <seconds> /ModRoute <source> <address> <depth>
+		int source = 0;
+		if (address == "/ModRoute") {
+			if (!(fields >> source >> address >> ev.cmd.value) || source < 0 || source >= MOD_SRC_COUNT) {
+				std::cerr << path << ":" << number << ": expected <seconds> /ModRoute <source> <address> <depth>\n";
+				return false;
+			}
+			ev.cmd.type = CMD_MOD_ROUTE;
+		}
+		else {
+			if (!(fields >> ev.cmd.value)) {
+				std::cerr << path << ":" << number << ": expected <seconds> <address> <value>\n";
+				return false;
+			}
+			ev.cmd.type = CMD_PARAM;
+		}
+
+		auto param = params.Find(address.c_str());
+		if (param < 0) {
+			std::cerr << path << ":" << number << ": unknown address " << address << "\n";
+			return false;
+		}
+		ev.cmd.id = (ev.cmd.type == CMD_MOD_ROUTE) ? source * PARAM_COUNT + param : param;
+		events.push_back(ev);
+	}
+
+	std::stable_sort(events.begin(), events.end(),
+					 [](const scriptEvent &a, const scriptEvent &b) { return a.time < b.time; });
+	return true;
+}
+
+// Writes the header of a mono 32 bit float wav file with the given number of samples
+void writeWavHeader(FILE *file, uint32_t fs, uint32_t samples)
+{
+	auto u16 = [&](uint32_t v) { uint8_t b[2] = {(uint8_t)v, (uint8_t)(v >> 8)}; fwrite(b, 1, 2, file); };
+	auto u32 = [&](uint32_t v) { u16(v & 0xFFFF); u16(v >> 16); };
+
+	auto data_size = samples * 4;
+	fwrite("RIFF", 1, 4, file);
+	u32(36 + data_size);
+	fwrite("WAVEfmt ", 1, 8, file);
+	u32(16);
+	u16(3);			// ieee float
+	u16(1);			// channels
+	u32(fs);
+	u32(fs * 4);	// bytes per second
+	u16(4);			// bytes per frame
+	u16(32);		// bits per sample
+	fwrite("data", 1, 4, file);
+	u32(data_size);
+}
+
+int main(int argc, char *argv[])
+{
+	// Command line options
+	const char *script = NULL;
+	const char *waveform = NULL;
+	uint32_t fs = 48000;
+	size_t block = 256;
+	size_t voices = 7;
+	size_t threads = 1;
+	double tail = 2.0;
+
+	static const struct option longOptions[] = {
+		{"script",		required_argument,	NULL, 's'},
+		{"rate",		required_argument,	NULL, 'r'},
+		{"block",		required_argument,	NULL, 'b'},
+		{"voices",		required_argument,	NULL, 'v'},
+		{"threads",		required_argument,	NULL, 't'},
+		{"tail",		required_argument,	NULL, 'T'},
+		{"waveform",	required_argument,	NULL, 'w'},
+		{"help",		no_argument,		NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	int opt;
+	while ((opt = getopt_long(argc, argv, "s:r:b:v:t:T:w:h", longOptions, NULL)) != -1) {
+		switch (opt) {
+			case 's':
+				script = optarg;
+				break;
+			case 'r':
+				fs = strtoul(optarg, NULL, 10);
+				break;
+			case 'b':
+				block = strtoul(optarg, NULL, 10);
+				break;
+			case 'v':
+				voices = strtoul(optarg, NULL, 10);
+				break;
+			case 't':
+				threads = strtoul(optarg, NULL, 10);
+				break;
+			case 'T':
+				tail = std::max(0.0, strtod(optarg, NULL));
+				break;
+			case 'w':
+				waveform = optarg;
+				break;
+			case 'h':
+				printUsage(argv[0]);
+				return 0;
+			default:
+				printUsage(argv[0]);
+				return 1;
+		}
+	}
+
+	if (argc - optind != 2 || fs == 0 || block == 0) {
+		printUsage(argv[0]);
+		return 1;
+	}
+	const char *input = argv[optind];
+	const char *output = argv[optind + 1];
+
+	// errors of the engine and the file readers go to the console
+	auto sink_cout = std::make_shared<AixLog::SinkCout>(AixLog::Severity::warning);
+	AixLog::Log::init({sink_cout});
+
+	SynthEngine engine(fs, block, voices, threads);
+	if (waveform != NULL && !engine.LoadWaveform(waveform))
+		return 1;
+
+	MidiFile midi;
+	if (!midi.Load(input))
+		return 1;
+
+	std::vector<scriptEvent> params;
+	if (script != NULL && !readScript(script, engine.GetParams(), params))
+		return 1;
+
+	auto length = midi.GetLength();
+	if (!params.empty())
+		length = std::max(length, params.back().time);
+	auto total = (uint64_t)std::ceil((length + tail) * fs);
+	if (total > 0xFFFFFFFFull / 4 - 36) {
+		std::cerr << "the rendering is too long for a wav file\n";
+		return 1;
+	}
+
+	FILE *file = fopen(output, "wb");
+	if (file == NULL) {
+		std::cerr << "could not create " << output << "\n";
+		return 1;
+	}
+	writeWavHeader(file, fs, (uint32_t)total);
+
+	typedef std::chrono::steady_clock clock;
+	std::chrono::duration<double> render_time(0.0);
+	auto start_time = clock::now();
+
+	std::vector<float> out(block);
+	size_t next_param = 0;
+	size_t next_midi = 0;
+	float peak = 0.0f;
+
+	for (uint64_t pos = 0; pos < total; pos += block) {
+		auto n = (size_t)std::min((uint64_t)block, total - pos);
+		auto last = (double)(n - 1);
+
+		// the events up to the last sample of this block at their frame, later ones and
+		// events which do not fit into the scheduler of the engine follow in the next block
+		while (next_param < params.size()) {
+			auto frame = std::max(0.0, params[next_param].time * fs - pos);
+			if (frame > last || !engine.Schedule(frame, params[next_param].cmd))
+				break;
+			next_param++;
+		}
+		while (next_midi < midi.GetCount()) {
+			auto &ev = midi.Get(next_midi);
+			auto frame = std::max(0.0, ev.time * fs - pos);
+			if (frame > last)
+				break;
+			synthCommand cmd;
+			if (SynthEngine::MidiToCommand(ev.status & 0xF0, ev.data1, ev.data2, cmd) && !engine.Schedule(frame, cmd))
+				break;
+			next_midi++;
+		}
+
+		auto block_start = clock::now();
+		engine.Render(out.data(), n);
+		render_time += clock::now() - block_start;
+
+		for (size_t i = 0; i < n; i++)
+			peak = std::max(peak, std::fabs(out[i]));
+		fwrite(out.data(), sizeof(float), n, file);
+	}
+
+	std::chrono::duration<double> total_time = clock::now() - start_time;
+	auto ok = !ferror(file);
+	ok = (fclose(file) == 0) && ok;
+	if (!ok) {
+		std::cerr << "could not write " << output << "\n";
+		return 1;
+	}
+
+	// realtime factor: seconds of audio per second of rendering
+	auto seconds = (double)total / fs;
+	printf("rendered %.2f s of audio, %zu midi events, %zu parameter changes, %zu voices\n",
+		   seconds, midi.GetCount(), params.size(), engine.GetVoices());
+	printf("render time %.3f s, realtime factor %.1f\n", render_time.count(), seconds / render_time.count());
+	printf("with file output %.3f s, realtime factor %.1f\n", total_time.count(), seconds / total_time.count());
+	printf("peak %.1f dBFS\n", 20.0 * std::log10(std::max(peak, 1e-10f)));
+
+	return 0;
+}
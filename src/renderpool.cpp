@@ -0,0 +1,211 @@
+/**
+ * @file renderpool.cpp
+ * @brief RenderPool class implementation.
+ */
+
+#include "renderpool.h"
+
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <aixlog.hpp>
+
+// spins before a waiting thread goes to sleep, a few microseconds
+static const int kSpins = 2000;
+
+static inline void
+cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+static void
+futex_wait(std::atomic<uint32_t> &word, uint32_t value)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+}
+
+static void
+futex_wake(std::atomic<uint32_t> &word)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+// wake the threads sleeping on word after it was changed, the system call is only made
+// if one of them went to sleep, sleepers counts them
+static void
+wake(std::atomic<uint32_t> &word, std::atomic<uint32_t> &sleepers)
+{
+    // pairs with the fence in wait_while: either this sees the sleeper,
+    // or the futex of the sleeper sees the new value of word
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers.load(std::memory_order_relaxed) != 0)
+        futex_wake(word);
+}
+
+// wait until word differs from value, return the new value
+static uint32_t
+wait_while(std::atomic<uint32_t> &word, uint32_t value, std::atomic<uint32_t> &sleepers)
+{
+    for (int i = 0; i < kSpins; i++)
+    {
+        auto v = word.load(std::memory_order_acquire);
+        if (v != value)
+            return v;
+        cpu_relax();
+    }
+
+    for (;;)
+    {
+        sleepers.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        futex_wait(word, value);
+        sleepers.fetch_sub(1, std::memory_order_relaxed);
+        auto v = word.load(std::memory_order_acquire);
+        if (v != value)
+            return v;
+    }
+}
+
+RenderPool::RenderPool(VoiceBank *bank, size_t threads, size_t max_frames, int priority)
+    : start_(0), pending_(0), start_sleepers_(0), pending_sleepers_(0), quit_(false)
+{
+    bank_ = bank;
+    max_frames_ = max_frames;
+    frames_ = 0;
+    active_ = 0;
+    parts_ = 1;
+
+    if (threads < 1)
+        threads = 1;
+
+    scratch_.resize(threads);
+    bus_.resize(threads - 1);
+
+    for (size_t w = 0; w + 1 < threads; w++)
+    {
+        bus_[w].assign(max_frames_, 0.0f);
+        workers_.push_back(std::thread(&RenderPool::worker, this, w));
+        setup_thread(w, priority);
+    }
+}
+
+RenderPool::~RenderPool()
+{
+    quit_.store(true, std::memory_order_relaxed);
+    start_.fetch_add(1, std::memory_order_release);
+    wake(start_, start_sleepers_);
+
+    for (auto &t : workers_)
+        t.join();
+}
+
+void
+RenderPool::setup_thread(size_t w, int priority)
+{
+    auto handle = workers_[w].native_handle();
+
+    // the calling thread usually runs on core 0, the workers take the next cores
+    auto cores = std::thread::hardware_concurrency();
+    if (cores > 1)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET((w + 1) % cores, &set);
+        if (pthread_setaffinity_np(handle, sizeof(set), &set) != 0)
+            LOG(WARNING) << "RenderPool: could not pin worker " << w << "\n";
+    }
+
+    if (priority > 0)
+    {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = priority;
+        auto err = pthread_setschedparam(handle, SCHED_FIFO, &param);
+        if (err != 0)
+            LOG(WARNING) << "RenderPool: no realtime priority for worker " << w << ": " << strerror(err) << "\n";
+    }
+}
+
+void
+RenderPool::RenderBlock(float *out, size_t n)
+{
+    bank_->UpdateWavetable();
+
+    // the buses are fixed size, so a larger block is split
+    for (size_t done = 0; done < n; done += max_frames_)
+    {
+        auto m = n - done;
+        if (m > max_frames_)
+            m = max_frames_;
+        render(out + done, m);
+    }
+    bank_->RetireIdle();
+}
+
+void
+RenderPool::render(float *out, size_t n)
+{
+    auto active = bank_->GetActiveCount();
+    auto parts = active / kMinVoices;
+    if (parts > workers_.size() + 1)
+        parts = workers_.size() + 1;
+
+    if (parts <= 1)
+    {
+        bank_->RenderActive(0, active, out, n, scratch_[0]);
+        return;
+    }
+
+    // fork, the job is published with the release of start_
+    frames_ = n;
+    active_ = active;
+    parts_ = parts;
+    pending_.store((uint32_t)workers_.size(), std::memory_order_relaxed);
+    start_.fetch_add(1, std::memory_order_release);
+    wake(start_, start_sleepers_);
+
+    bank_->RenderActive(0, active / parts, out, n, scratch_[0]);
+
+    // join
+    uint32_t left;
+    while ((left = pending_.load(std::memory_order_acquire)) != 0)
+        wait_while(pending_, left, pending_sleepers_);
+
+    for (size_t w = 0; w + 1 < parts; w++)
+    {
+        auto bus = bus_[w].data();
+        for (size_t i = 0; i < n; i++)
+            out[i] += bus[i];
+    }
+}
+
+void
+RenderPool::worker(size_t w)
+{
+    uint32_t seen = 0;
+    for (;;)
+    {
+        seen = wait_while(start_, seen, start_sleepers_);
+        if (quit_.load(std::memory_order_relaxed))
+            return;
+
+        // part w + 1 of the active set, workers without a part only report back
+        auto part = w + 1;
+        if (part < parts_)
+        {
+            auto first = active_ * part / parts_;
+            auto last = active_ * (part + 1) / parts_;
+            bank_->RenderActive(first, last, bus_[w].data(), frames_, scratch_[part]);
+        }
+
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            wake(pending_, pending_sleepers_);
+    }
+}
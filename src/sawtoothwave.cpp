@@ -3,6 +3,7 @@
 // sawtoothsginal is generated with sawtooth formula (no additive sinusoidal synthesis)
 
 #include "sawtoothwave.h"
+#include "polyblep.h"
 
 // Constructor
 Sawtoothwave::Sawtoothwave(double f, double a, double p,  int fS)
@@ -12,6 +13,7 @@ Sawtoothwave::Sawtoothwave(double f, double a, double p,  int fS)
     phi     = p;
     fs      = fS;
     curr_ampl = 0.0;
+    blepOn  = false;
 }
 
 double Sawtoothwave::getNextSample() {
@@ -23,15 +25,18 @@ double Sawtoothwave::getNextSample() {
 
     double n=2.0*M_PI * freq * (1.0/fs);
     
-    //double thisVal=amp*((phi-fs/freq*n)   -(long)(phi-fs/freq*n));
-    double thisVal=phi;
-    
+    double thisVal=(phi-M_PI)/M_PI;
+
+    // smooth the jump at the end of the period
+    if (blepOn)
+        thisVal -= polyblep_residual((float)(phi/(2.0*M_PI)), (float)(n/(2.0*M_PI)));
+
     // apply amplitude
-    thisVal = amp*(thisVal-M_PI)/M_PI;
+    thisVal = amp*thisVal;
     
-     // rotate to next step
+     // rotate to next step, the wrap keeps the fractional phase
     phi += n;
-    if (phi>=2.0*M_PI) phi=0;
+    if (phi>=2.0*M_PI) phi-=2.0*M_PI;
 
     curr_ampl = thisVal;
 
@@ -39,6 +44,41 @@ double Sawtoothwave::getNextSample() {
 
 }
 
+void Sawtoothwave::renderBlock(float *out, size_t n) {
+
+    /// This method renders the next n samples of the Sawtoothwave.
+    /// The phase (in periods) of every sample is written to out
+    /// first, so the waveform loop below has no branches.
+
+    double p = phi;
+    double inc = 2.0*M_PI * freq * (1.0/fs);
+
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (float)(p/(2.0*M_PI));
+
+        // rotate to next step
+        p += inc;
+        if (p>=2.0*M_PI) p-=2.0*M_PI;
+    }
+
+    float a = (float)amp;
+    float dt = (float)(inc/(2.0*M_PI));
+
+    if (blepOn) {
+        for (size_t i = 0; i < n; i++) {
+            float t = out[i];
+            out[i] = a*(2.0f*t - 1.0f - polyblep_residual(t, dt));
+        }
+    } else {
+        for (size_t i = 0; i < n; i++)
+            out[i] = a*(2.0f*out[i] - 1.0f);
+    }
+
+    phi = p;
+    if (n > 0)
+        curr_ampl = out[n-1];
+}
+
 // getter methods
 
 double Sawtoothwave::frequency() {
@@ -73,3 +113,11 @@ void Sawtoothwave::phase(double p) {
     phi = p;
 
 }
+
+void Sawtoothwave::polyblep(bool on) {
+    blepOn = on;
+}
+
+bool Sawtoothwave::polyblep() {
+    return blepOn;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file sinekernel.cpp
+ * @brief SineKernel class implementation.
+ */
+
+#include "sinekernel.h"
+
+#include <math.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SINEKERNEL_X86
+#include <immintrin.h>
+#endif
+
+// 2 pi and pi split into a float and the rest, for the phase reduction
+static const float kInvTwoPi = 0.159154943f;
+static const float kTwoPiHi = 6.28318548f;
+static const float kTwoPiLo = -1.74845553e-7f;
+static const float kPiHi = 3.14159274f;
+static const float kPiLo = -8.74227766e-8f;
+static const float kHalfPi = 1.57079637f;
+
+// sin(x) = x + x^3 * (c1 + c2 x^2 + c3 x^4 + c4 x^6) on [-pi/2, pi/2]
+static const float kC1 = -1.66666571e-1f;
+static const float kC2 = 8.33301729e-3f;
+static const float kC3 = -1.98066151e-4f;
+static const float kC4 = 2.60005460e-6f;
+
+static void
+process_scalar(const float *phase, float *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        auto x = phase[i];
+        // reduce to [-pi, pi]
+        auto k = floorf(x * kInvTwoPi + 0.5f);
+        auto r = (x - k * kTwoPiHi) - k * kTwoPiLo;
+        // fold to [-pi/2, pi/2]
+        r = (r > kHalfPi) ? (kPiHi - r) + kPiLo : r;
+        r = (r < -kHalfPi) ? (-kPiHi - r) - kPiLo : r;
+
+        auto r2 = r * r;
+        auto p = ((kC4 * r2 + kC3) * r2 + kC2) * r2 + kC1;
+        out[i] = r + r * r2 * p;
+    }
+}
+
+#ifdef SINEKERNEL_X86
+
+__attribute__((target("sse2")))
+static void
+process_sse2(const float *phase, float *out, size_t n)
+{
+    const __m128 inv_two_pi = _mm_set1_ps(kInvTwoPi);
+    const __m128 two_pi_hi = _mm_set1_ps(kTwoPiHi);
+    const __m128 two_pi_lo = _mm_set1_ps(kTwoPiLo);
+    const __m128 pi_hi = _mm_set1_ps(kPiHi);
+    const __m128 pi_lo = _mm_set1_ps(kPiLo);
+    const __m128 half_pi = _mm_set1_ps(kHalfPi);
+    const __m128 neg_half_pi = _mm_set1_ps(-kHalfPi);
+    const __m128 zero = _mm_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        auto x = _mm_loadu_ps(phase + i);
+        // cvtps rounds to nearest with the default rounding mode
+        auto k = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x, inv_two_pi)));
+        auto r = _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(k, two_pi_hi)), _mm_mul_ps(k, two_pi_lo));
+
+        auto gt = _mm_cmpgt_ps(r, half_pi);
+        auto rp = _mm_add_ps(_mm_sub_ps(pi_hi, r), pi_lo);
+        r = _mm_or_ps(_mm_and_ps(gt, rp), _mm_andnot_ps(gt, r));
+        auto lt = _mm_cmplt_ps(r, neg_half_pi);
+        auto rm = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(zero, pi_hi), r), pi_lo);
+        r = _mm_or_ps(_mm_and_ps(lt, rm), _mm_andnot_ps(lt, r));
+
+        auto r2 = _mm_mul_ps(r, r);
+        auto p = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(kC4), r2), _mm_set1_ps(kC3));
+        p = _mm_add_ps(_mm_mul_ps(p, r2), _mm_set1_ps(kC2));
+        p = _mm_add_ps(_mm_mul_ps(p, r2), _mm_set1_ps(kC1));
+        p = _mm_mul_ps(_mm_mul_ps(p, r2), r);
+        _mm_storeu_ps(out + i, _mm_add_ps(r, p));
+    }
+    process_scalar(phase + i, out + i, n - i);
+}
+
+__attribute__((target("avx2,fma")))
+static void
+process_avx2(const float *phase, float *out, size_t n)
+{
+    const __m256 inv_two_pi = _mm256_set1_ps(kInvTwoPi);
+    const __m256 two_pi_hi = _mm256_set1_ps(kTwoPiHi);
+    const __m256 two_pi_lo = _mm256_set1_ps(kTwoPiLo);
+    const __m256 pi_hi = _mm256_set1_ps(kPiHi);
+    const __m256 pi_lo = _mm256_set1_ps(kPiLo);
+    const __m256 neg_pi_hi = _mm256_set1_ps(-kPiHi);
+    const __m256 half_pi = _mm256_set1_ps(kHalfPi);
+    const __m256 neg_half_pi = _mm256_set1_ps(-kHalfPi);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        auto x = _mm256_loadu_ps(phase + i);
+        auto k = _mm256_round_ps(_mm256_mul_ps(x, inv_two_pi), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        auto r = _mm256_fnmadd_ps(k, two_pi_lo, _mm256_fnmadd_ps(k, two_pi_hi, x));
+
+        auto gt = _mm256_cmp_ps(r, half_pi, _CMP_GT_OQ);
+        r = _mm256_blendv_ps(r, _mm256_add_ps(_mm256_sub_ps(pi_hi, r), pi_lo), gt);
+        auto lt = _mm256_cmp_ps(r, neg_half_pi, _CMP_LT_OQ);
+        r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_sub_ps(neg_pi_hi, r), pi_lo), lt);
+
+        auto r2 = _mm256_mul_ps(r, r);
+        auto p = _mm256_fmadd_ps(_mm256_set1_ps(kC4), r2, _mm256_set1_ps(kC3));
+        p = _mm256_fmadd_ps(p, r2, _mm256_set1_ps(kC2));
+        p = _mm256_fmadd_ps(p, r2, _mm256_set1_ps(kC1));
+        _mm256_storeu_ps(out + i, _mm256_fmadd_ps(_mm256_mul_ps(p, r2), r, r));
+    }
+    process_scalar(phase + i, out + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+static void
+process_avx512(const float *phase, float *out, size_t n)
+{
+    const __m512 inv_two_pi = _mm512_set1_ps(kInvTwoPi);
+    const __m512 two_pi_hi = _mm512_set1_ps(kTwoPiHi);
+    const __m512 two_pi_lo = _mm512_set1_ps(kTwoPiLo);
+    const __m512 pi_hi = _mm512_set1_ps(kPiHi);
+    const __m512 pi_lo = _mm512_set1_ps(kPiLo);
+    const __m512 neg_pi_hi = _mm512_set1_ps(-kPiHi);
+    const __m512 half_pi = _mm512_set1_ps(kHalfPi);
+    const __m512 neg_half_pi = _mm512_set1_ps(-kHalfPi);
+    const __mmask16 all = 0xFFFF;
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        auto x = _mm512_loadu_ps(phase + i);
+        // the zero masked form avoids a false uninitialized warning of gcc 12
+        auto k = _mm512_maskz_roundscale_ps(all, _mm512_mul_ps(x, inv_two_pi), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        auto r = _mm512_fnmadd_ps(k, two_pi_lo, _mm512_fnmadd_ps(k, two_pi_hi, x));
+
+        auto gt = _mm512_cmp_ps_mask(r, half_pi, _CMP_GT_OQ);
+        r = _mm512_mask_blend_ps(gt, r, _mm512_add_ps(_mm512_sub_ps(pi_hi, r), pi_lo));
+        auto lt = _mm512_cmp_ps_mask(r, neg_half_pi, _CMP_LT_OQ);
+        r = _mm512_mask_blend_ps(lt, r, _mm512_sub_ps(_mm512_sub_ps(neg_pi_hi, r), pi_lo));
+
+        auto r2 = _mm512_mul_ps(r, r);
+        auto p = _mm512_fmadd_ps(_mm512_set1_ps(kC4), r2, _mm512_set1_ps(kC3));
+        p = _mm512_fmadd_ps(p, r2, _mm512_set1_ps(kC2));
+        p = _mm512_fmadd_ps(p, r2, _mm512_set1_ps(kC1));
+        _mm512_storeu_ps(out + i, _mm512_fmadd_ps(_mm512_mul_ps(p, r2), r, r));
+    }
+    process_scalar(phase + i, out + i, n - i);
+}
+
+#endif // SINEKERNEL_X86
+
+void
+SineKernel::Process(const float *phase, float *out, size_t n)
+{
+    ProcessWith(CpuIsa::Get(), phase, out, n);
+}
+
+void
+SineKernel::ProcessWith(int isa, const float *phase, float *out, size_t n)
+{
+    switch (isa)
+    {
+#ifdef SINEKERNEL_X86
+        case ISA_AVX512:
+            process_avx512(phase, out, n);
+            break;
+        case ISA_AVX2:
+            process_avx2(phase, out, n);
+            break;
+        case ISA_SSE2:
+            process_sse2(phase, out, n);
+            break;
+#endif
+        default:
+            process_scalar(phase, out, n);
+            break;
+    }
+}
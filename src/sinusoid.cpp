@@ -3,6 +3,8 @@
 // Sinusoid signal is generated with sin function from math.h
 #include "sinusoid.h"
 
+#include "sinekernel.h"
+
 Sinusoid::Sinusoid(double f, double a, double p,  int fS) {
     freq    = f;
     amp     = a;
@@ -27,9 +29,9 @@ double Sinusoid::getNextSample() {
     // rotate to next step
     phi += 2.0*M_PI * freq * (1.0/fs);
 
-    // wrap to 2 pi
+    // wrap to 2 pi, keeping the fractional phase
     if(phi>=2*M_PI)
-        phi=0;
+        phi-=2*M_PI;
 
     curr_ampl = thisVal;
 
@@ -37,6 +39,35 @@ double Sinusoid::getNextSample() {
 
 }
 
+void Sinusoid::renderBlock(float *out, size_t n) {
+
+    /// This method renders the next n samples of the sinusoid.
+    /// The phase is accumulated in double precision and the sine
+    /// of the whole block is computed by the vectorized SineKernel.
+
+    double p = phi;
+    double inc = 2.0*M_PI * freq * (1.0/fs);
+
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (float)p;
+
+        // rotate to next step and wrap to 2 pi
+        p += inc;
+        if(p>=2*M_PI)
+            p-=2*M_PI;
+    }
+
+    SineKernel::Process(out, out, n);
+
+    float a = (float)amp;
+    for (size_t i = 0; i < n; i++)
+        out[i] *= a;
+
+    phi = p;
+    if (n > 0)
+        curr_ampl = out[n-1];
+}
+
 // getter methods
 double Sinusoid::frequency() {
     return freq;
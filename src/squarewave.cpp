@@ -3,6 +3,7 @@
 // square sginal is generated with  formula (no additive sinusoidal synthesis)
 
 #include "squarewave.h"
+#include "polyblep.h"
 
 Squarewave::Squarewave(double f, double a, double p,  int fS) {
     freq    = f;
@@ -10,6 +11,7 @@ Squarewave::Squarewave(double f, double a, double p,  int fS) {
     phi     = p;
     fs      = fS;
     curr_ampl = 0.0;
+    blepOn  = false;
 }
 
 double Squarewave::getNextSample() {
@@ -18,6 +20,8 @@ double Squarewave::getNextSample() {
     /// The amplitude is applied and the angle of the
     /// squarewave is increased, according to the sample rate.
 
+    double inc = 2.0*M_PI * freq * (1.0/fs);
+
     // get squarewave value
 	double thisVal = -1.0;
 
@@ -25,15 +29,23 @@ double Squarewave::getNextSample() {
 		thisVal = 1.0;
 	}
 
+    // smooth the jumps up at 0 and down at pi
+    if (blepOn) {
+        float t = (float)(phi/(2.0*M_PI));
+        float dt = (float)(inc/(2.0*M_PI));
+        float t2 = (t < 0.5f) ? t + 0.5f : t - 0.5f;
+        thisVal += polyblep_residual(t, dt) - polyblep_residual(t2, dt);
+    }
+
     // apply amplitude
     thisVal = thisVal*amp;
 
     // rotate to next step
-    phi += 2.0*M_PI * freq * (1.0/fs);
+    phi += inc;
 
-    // wrap to 2 pi
+    // wrap to 2 pi, keeping the fractional phase
     if(phi>=2*M_PI)
-        phi=0;
+        phi-=2*M_PI;
 
 
     curr_ampl = thisVal;
@@ -43,6 +55,44 @@ double Squarewave::getNextSample() {
 
 }
 
+void Squarewave::renderBlock(float *out, size_t n) {
+
+    /// This method renders the next n samples of the squarewave.
+    /// The phase (in periods) of every sample is written to out
+    /// first, so the waveform loop below has no branches.
+
+    double p = phi;
+    double inc = 2.0*M_PI * freq * (1.0/fs);
+
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (float)(p/(2.0*M_PI));
+
+        // rotate to next step and wrap to 2 pi
+        p += inc;
+        if(p>=2*M_PI)
+            p-=2*M_PI;
+    }
+
+    float a = (float)amp;
+    float dt = (float)(inc/(2.0*M_PI));
+
+    if (blepOn) {
+        for (size_t i = 0; i < n; i++) {
+            float t = out[i];
+            float t2 = (t < 0.5f) ? t + 0.5f : t - 0.5f;
+            float v = (t <= 0.5f) ? 1.0f : -1.0f;
+            out[i] = a*(v + polyblep_residual(t, dt) - polyblep_residual(t2, dt));
+        }
+    } else {
+        for (size_t i = 0; i < n; i++)
+            out[i] = (out[i] <= 0.5f) ? a : -a;
+    }
+
+    phi = p;
+    if (n > 0)
+        curr_ampl = out[n-1];
+}
+
 
 //getters
 double Squarewave::frequency() {
@@ -78,3 +128,10 @@ void Squarewave::phase(double p) {
     phi = p;
 }
 
+void Squarewave::polyblep(bool on) {
+    blepOn = on;
+}
+
+bool Squarewave::polyblep() {
+    return blepOn;
+}
@@ -0,0 +1,593 @@
+/**
+ * @file synthengine.cpp
+ * @brief SynthEngine class implementation.
+ */
+
+#include "synthengine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <aixlog.hpp>
+
+SynthEngine::SynthEngine(uint32_t fs, size_t max_block, size_t voices, size_t threads)
+{
+    fs_ = fs;
+    max_block_ = max_block;
+    gain_ = 1.0;
+
+    // polyphony, limited to 1 to kMaxVoices
+    // (compared, not passed to std::min, which would need a definition of the constant)
+    if (voices < 1)
+        voices = 1;
+    if (voices > kMaxVoices)
+        voices = kMaxVoices;
+    // voice bank holding all available playable notes
+    voices_ = new VoiceBank(fs_, voices);
+    // assigns the notes to the voices of the bank
+    allocator_ = new VoiceAllocator(voices_);
+
+    // optional worker threads, which render the voices in parallel
+    if (threads > kMaxThreads)
+        threads = kMaxThreads;
+    pool_ = NULL;
+    if (threads > 1)
+        pool_ = new RenderPool(voices_, threads, max_block_, kRenderPriority);
+
+    register_params();
+
+    // the filter object is created
+    filter_ = new Biquad(0, 0.01, 0.2, 1.0);
+    // creates the lfo oscillator
+    lfo_ = new Oscicontainer(fs_, 0, 1);
+    // disortion object is created
+    distortion_ = new Distortion();
+
+    filter_status_ = false;
+    distortion_status_ = false;
+
+    control_left_ = 0;
+    last_voice_ = -1;
+    cutoff_ = (float)(10100.0 / fs_);
+    cutoff_step_ = 0.0f;
+
+    cutoff_block_.resize(max_block_);
+    lfo_block_.resize(kControlBlock);
+
+    // every parameter starts at its default, so a route to any of them modulates around it
+    static const struct { int id; double value; } defaults[] = {
+        { PARAM_SINE_AMPL,                  1.0 },
+        { PARAM_SAW_AMPL,                   0.0 },
+        { PARAM_SQUARE_AMPL,                0.0 },
+        { PARAM_NOISE_AMPL,                 0.0 },
+        { PARAM_WAVE_AMPL,                  0.0 },
+        { PARAM_WAVETABLE,                  0.0 },
+        { PARAM_POLYBLEP,                   0.0 },
+        { PARAM_FILTER_Q,                   0.2 },
+        { PARAM_FILTER_TYPE,                LOWPASS },
+        { PARAM_FILTER_GAIN,                1.0 },
+        { PARAM_FILTER_STATUS,              0.0 },
+        { PARAM_FILTER_CUTOFF,              10100.0 },
+        { PARAM_LFO_FREQ,                   1.0 },
+        { PARAM_LFO_TYPE,                   0.0 },
+        { PARAM_GAIN,                       1.0 },
+        { PARAM_DISTORTION_DRIVE,           1.0 },
+        { PARAM_DISTORTION_RANGE,           0.8 },
+        { PARAM_DISTORTION_BLEND,           0.8 },
+        { PARAM_DISTORTION_OVERSAMPLING,    1.0 },
+        { PARAM_DISTORTION_MODEL,           DISTORTION_ATAN },
+        { PARAM_DISTORTION_STATUS,          0.0 },
+        { PARAM_ADSR_STATUS,                0.0 },
+        { PARAM_ADSR_SUSTAIN,               99.0 },
+        { PARAM_ADSR_ATTACK,                1.0 },
+        { PARAM_ADSR_RELEASE,               1.0 },
+        { PARAM_ADSR_DECAY,                 1.0 },
+    };
+    for (auto &param : defaults)
+        set_param(param.id, param.value);
+
+    // the lfo sweeps the cutoff from 200 Hz to 20 kHz
+    mod_.AddRoute(MOD_SRC_LFO, PARAM_FILTER_CUTOFF, 9900.0);
+}
+
+SynthEngine::~SynthEngine()
+{
+    delete pool_;
+    delete allocator_;
+    delete voices_;
+    delete filter_;
+    delete lfo_;
+    delete distortion_;
+}
+
+bool
+SynthEngine::Schedule(double frame, const synthCommand &cmd)
+{
+    // a later event could not be rendered in any block
+    if (!(frame < (double)max_block_))
+        return false;
+    return scheduler_.Add(frame, cmd);
+}
+
+void
+SynthEngine::Render(float *out, size_t n)
+{
+    // the voices are rendered up to the first sample at or after each event, then it is
+    // applied with the fraction of a sample it lies before that sample,
+    // events without a sample at or after them in this block are kept for the next one,
+    // the modulation matrix is evaluated every kControlBlock samples, counted across blocks
+    scheduler_.Sort();
+    size_t pos = 0;
+    size_t ev = 0;
+    while (pos < n)
+    {
+        if (control_left_ == 0)
+        {
+            modulate();
+            control_left_ = kControlBlock;
+        }
+        auto end = std::min(n, pos + control_left_);
+
+        for (; ev < scheduler_.GetCount(); ev++)
+        {
+            auto &event = scheduler_.Get(ev);
+            // events carried over from the last block have a frame in (-1, 0)
+            auto frame = (size_t)std::max(0.0, std::ceil(event.frame));
+            if (frame >= end)
+                break;
+            render_voices(out + pos, cutoff_block_.data() + pos, frame - pos);
+            control_left_ -= frame - pos;
+            pos = frame;
+            apply_command(event.cmd, frame - event.frame);
+        }
+
+        render_voices(out + pos, cutoff_block_.data() + pos, end - pos);
+        control_left_ -= end - pos;
+        pos = end;
+    }
+    scheduler_.Advance(ev, n);
+
+    auto scale = (float)(gain_ * kMixGain);
+    for (size_t i = 0; i < n; i++)
+        out[i] *= scale;
+
+    // apply filter, with the cutoff of every sample
+    if (filter_status_)
+        filter_->ProcessBlock(out, cutoff_block_.data(), n);
+
+    // apply distortion
+    if (distortion_status_)
+        distortion_->ProcessBlock(out, n);
+}
+
+bool
+SynthEngine::MidiToCommand(uint8_t status, uint8_t data1, uint8_t data2, synthCommand &cmd)
+{
+    cmd.id = data1;
+    cmd.value = 0.0;
+
+    if (status == 144 && data2 > 0)
+    {
+        // note-on procedure
+        cmd.type = CMD_NOTE_ON;
+        cmd.value = data2 / 126.0;
+    }
+    else if (status == 128 || status == 144)
+        // note-off procedure
+        cmd.type = CMD_NOTE_OFF;
+    else if (status == 176)
+    {
+        // control change, a source of the modulation matrix
+        cmd.type = CMD_CONTROL;
+        cmd.value = data2 / 127.0;
+    }
+    else
+        return false;
+
+    return true;
+}
+
+void
+SynthEngine::apply_command(const synthCommand &cmd, double offset)
+{
+    auto val = cmd.value;
+
+    if (cmd.type == CMD_NOTE_ON)
+    {
+        //formula to calculate the frequency from midi note value
+        auto f0 = std::pow(2.0, ((double)cmd.id-69.0) / 12.0) * 440.0;
+
+        //find a free oscillator, if all are used the allocator steals one
+        auto osci_nummer = allocator_->NoteOn(cmd.id);
+
+        //hand frequency, amplitude and ADSR data to the voice, the phase is reset
+        if (osci_nummer >= 0) {
+            voices_->NoteOn(osci_nummer, f0, val, offset);
+            last_voice_ = osci_nummer;
+        }
+        mod_.SetSource(MOD_SRC_VELOCITY, val);
+        return;
+    }
+
+    if (cmd.type == CMD_NOTE_OFF)
+    {
+        //find the oscillator that plays the note, it stays in use until its release has finished
+        auto position = allocator_->NoteOff(cmd.id);
+
+        if(position >= 0)
+            // enter into release mode
+            voices_->NoteOff(position);
+        return;
+    }
+
+    if (cmd.type == CMD_CONTROL)
+    {
+        mod_.SetSource(MOD_SRC_CC + cmd.id, val);
+        return;
+    }
+
+    if (cmd.type == CMD_MOD_ROUTE)
+    {
+        // between two rendered parts, so the matrix is not read meanwhile
+        AddModRoute(cmd.id / PARAM_COUNT, cmd.id % PARAM_COUNT, val);
+        return;
+    }
+
+    set_param(cmd.id, val);
+}
+
+void
+SynthEngine::set_param(int id, double value)
+{
+    // the value is also the base of the modulation of the parameter
+    mod_.SetBase(id, value);
+    params_.Set(this, id, value);
+}
+
+bool
+SynthEngine::AddModRoute(int source, int param, double depth)
+{
+    // the matrix is read by the rendering thread without a lock
+    return mod_.AddRoute(source, param, depth) >= 0;
+}
+
+void
+SynthEngine::modulate()
+{
+    // the lfo advances by one control block, its value at the start of the block is the source
+    lfo_->renderBlock(lfo_block_.data(), kControlBlock);
+    mod_.SetSource(MOD_SRC_LFO, lfo_block_[0]);
+    mod_.SetSource(MOD_SRC_ENVELOPE, (last_voice_ >= 0) ? voices_->GetLevel(last_voice_) : 0.0f);
+    mod_.Evaluate();
+
+    // modulated parameters are set through their setters, once per control block
+    for (size_t i = 0; i < mod_.GetTargetCount(); i++) {
+        auto id = mod_.GetTarget(i);
+        if (id != PARAM_FILTER_CUTOFF)
+            params_.Set(this, id, mod_.GetValue(id));
+    }
+
+    // the cutoff instead moves sample by sample to its new value within the block,
+    // the filter looks the coefficients up for every sample, so it does not step
+    auto cutoff = std::max(0.0f, mod_.GetValue(PARAM_FILTER_CUTOFF)) / fs_;
+    cutoff_step_ = (cutoff - cutoff_) / kControlBlock;
+}
+
+void
+SynthEngine::render_voices(float *out, float *cutoff, size_t n)
+{
+    if (n == 0)
+        return;
+
+    for (size_t i = 0; i < n; i++) {
+        cutoff_ += cutoff_step_;
+        cutoff[i] = cutoff_;
+    }
+
+    // one pass over all voices of the bank, split over the render threads if there are any
+    if (pool_ != NULL)
+        pool_->RenderBlock(out, n);
+    else
+        voices_->RenderBlock(out, n);
+    // voices whose release has finished can be used again
+    allocator_->Reclaim();
+}
+
+// Registers the osc address and the setter of every parameter,
+// a new parameter needs an id in synthcommand.h and a line here
+void
+SynthEngine::register_params()
+{
+    params_.Add("/SineAmpl",			PARAM_SINE_AMPL,			[](SynthEngine *s, double v) { s->SetAllSineAmpl(v); });
+    params_.Add("/SawAmpl",				PARAM_SAW_AMPL,				[](SynthEngine *s, double v) { s->SetAllSawAmpl(v); });
+    params_.Add("/SquareAmpl",			PARAM_SQUARE_AMPL,			[](SynthEngine *s, double v) { s->SetAllSquareAmpl(v); });
+    params_.Add("/NoiseAmpl",			PARAM_NOISE_AMPL,			[](SynthEngine *s, double v) { s->SetAllNoiseAmpl(v); });
+    params_.Add("/WaveAmpl",			PARAM_WAVE_AMPL,			[](SynthEngine *s, double v) { s->SetAllWaveAmpl(v); });
+    params_.Add("/Wavetable",			PARAM_WAVETABLE,			[](SynthEngine *s, double v) { s->SetAllWavetable((int)v); });
+    params_.Add("/PolyBLEP",			PARAM_POLYBLEP,				[](SynthEngine *s, double v) { s->SetAllPolyBLEP((int)v); });
+    params_.Add("/LFO_Q",				PARAM_FILTER_Q,				[](SynthEngine *s, double v) { s->filter_->SetQ(v); });
+    params_.Add("/Filter_Type",			PARAM_FILTER_TYPE,			[](SynthEngine *s, double v) { s->filter_->SetType((filterType)std::round(v)); });
+    params_.Add("/Filter_Gain",			PARAM_FILTER_GAIN,			[](SynthEngine *s, double v) { s->filter_->SetPeakGain(v); });
+    params_.Add("/Filter_Status",		PARAM_FILTER_STATUS,		[](SynthEngine *s, double v) { s->filter_status_ = (int)v; });
+    params_.Add("/Filter_Cutoff",		PARAM_FILTER_CUTOFF,		[](SynthEngine *s, double v) { s->filter_->SetFc(v / s->fs_); });
+    params_.Add("/LFO_Freq",			PARAM_LFO_FREQ,				[](SynthEngine *s, double v) { s->lfo_->frequency(v); });
+    params_.Add("/LFO_Type",			PARAM_LFO_TYPE,				[](SynthEngine *s, double v) { s->lfo_->setLFOtype((int)v); });
+    params_.Add("/Gain",				PARAM_GAIN,					[](SynthEngine *s, double v) { s->SetGain(v); });
+    params_.Add("/Distortion_Drive",	PARAM_DISTORTION_DRIVE,		[](SynthEngine *s, double v) { s->distortion_->SetDrive(v); });
+    params_.Add("/Distortion_Range",	PARAM_DISTORTION_RANGE,		[](SynthEngine *s, double v) { s->distortion_->SetRange(v); });
+    params_.Add("/Distortion_Blend",	PARAM_DISTORTION_BLEND,		[](SynthEngine *s, double v) { s->distortion_->SetBlend(v); });
+    params_.Add("/Distortion_Oversampling",	PARAM_DISTORTION_OVERSAMPLING,	[](SynthEngine *s, double v) { s->distortion_->SetOversampling((size_t)v); });
+    params_.Add("/Distortion_Model",	PARAM_DISTORTION_MODEL,		[](SynthEngine *s, double v) { s->distortion_->SetModel((int)v); });
+    params_.Add("/Distortion_Status",	PARAM_DISTORTION_STATUS,	[](SynthEngine *s, double v) { s->distortion_status_ = (int)v; });
+    params_.Add("/ADSR_Status",			PARAM_ADSR_STATUS,			[](SynthEngine *s, double v) { s->SetAllADSRStatus(v); });
+    params_.Add("/ADSR_Sustain_Level",	PARAM_ADSR_SUSTAIN,			[](SynthEngine *s, double v) { s->SetAllADSRSustainLevel(v); });
+    params_.Add("/ADSR_Attack_Time",	PARAM_ADSR_ATTACK,			[](SynthEngine *s, double v) { s->SetAllADSRAttackTime(v); });
+    params_.Add("/ADSR_Release_Time",	PARAM_ADSR_RELEASE,			[](SynthEngine *s, double v) { s->SetAllADSRReleaseTime(v); });
+    params_.Add("/ADSR_Decay_Time",		PARAM_ADSR_DECAY,			[](SynthEngine *s, double v) { s->SetAllADSRDecayTime(v); });
+    params_.Add("/Preset",				PARAM_PRESET,				[](SynthEngine *s, double v) { s->SetPreset((int)std::round(v)); });
+    params_.Build();
+}
+
+// These functions help to make changes to all voices of the voice bank
+
+void
+SynthEngine::SetAllSineAmpl(double val)
+{
+    voices_->SetSineAmpl(val);
+}
+
+void
+SynthEngine::SetAllSawAmpl(double val)
+{
+    voices_->SetSawAmpl(val);
+}
+
+void
+SynthEngine::SetAllSquareAmpl(double val)
+{
+    voices_->SetSquareAmpl(val);
+}
+
+void
+SynthEngine::SetAllNoiseAmpl(double val)
+{
+    val = val * 0.5;
+    voices_->SetNoiseAmpl(val);
+}
+
+void
+SynthEngine::SetAllWaveAmpl(double val)
+{
+    voices_->SetWaveAmpl(val);
+}
+
+// 1 switches all voices to the band-limited wavetables
+void
+SynthEngine::SetAllWavetable(int val)
+{
+    voices_->SetWavetable(val == 1);
+}
+
+// 1 switches the naive saw and square of all voices to PolyBLEP anti-aliasing
+void
+SynthEngine::SetAllPolyBLEP(int val)
+{
+    voices_->SetPolyBLEP(val == 1);
+}
+
+// loads a single cycle wav file as user waveform, see "/WaveAmpl"
+bool
+SynthEngine::LoadWaveform(const char *path)
+{
+    return voices_->LoadWaveform(path);
+}
+
+void
+SynthEngine::SetAllADSRStatus(int val)
+{
+    voices_->SetADSRStatus(val == 1);
+}
+
+void
+SynthEngine::SetAllADSRSustainLevel(double val)
+{
+    voices_->SetADSRSustain(val);
+}
+
+void
+SynthEngine::SetAllADSRAttackTime(double val)
+{
+    voices_->SetADSRAttack(val);
+}
+
+void
+SynthEngine::SetAllADSRReleaseTime(double val)
+{
+    voices_->SetADSRRelease(val);
+}
+
+void
+SynthEngine::SetAllADSRDecayTime(double val)
+{
+    voices_->SetADSRDecay(val);
+}
+
+void
+SynthEngine::SetPreset(int preset)
+{
+    // through set_param, so the preset values are also the bases of the modulation
+    switch(preset) {
+
+        case wobble:
+
+            //oscillator settings
+            set_param(PARAM_SINE_AMPL, 1);
+            set_param(PARAM_SQUARE_AMPL, 1);
+            set_param(PARAM_SAW_AMPL, 1);
+            set_param(PARAM_NOISE_AMPL, 0);
+
+            //ADSR Settings
+            set_param(PARAM_ADSR_STATUS, 0);
+            /*SetAllADSRAttackTime(1);
+            SetAllADSRDecayTime(1);
+            SetAllADSRReleaseTime(1);
+            SetAllADSRSustainLevel(1);*/
+
+            //Biquad settings
+            set_param(PARAM_FILTER_STATUS, 1);
+            set_param(PARAM_FILTER_TYPE, filterType::LOWSHELF);
+            //filter_->setQ(1);
+            set_param(PARAM_FILTER_GAIN, 100);
+
+            //lfo settings
+            set_param(PARAM_LFO_TYPE, 0);
+            set_param(PARAM_LFO_FREQ, 2);
+
+            //gain (distortion) settings
+            set_param(PARAM_DISTORTION_DRIVE, 3.0);
+            set_param(PARAM_DISTORTION_MODEL, DISTORTION_ATAN);
+            set_param(PARAM_DISTORTION_OVERSAMPLING, 2);
+
+
+        break;
+
+        case dreamy:
+
+            //oscillator settings
+            set_param(PARAM_SINE_AMPL, 1);
+            set_param(PARAM_SQUARE_AMPL, 1);
+            set_param(PARAM_SAW_AMPL, 0);
+            set_param(PARAM_NOISE_AMPL, 0);
+
+            //ADSR Settings
+            set_param(PARAM_ADSR_STATUS, 1);
+            set_param(PARAM_ADSR_ATTACK, 20);
+            set_param(PARAM_ADSR_DECAY, 80);
+            set_param(PARAM_ADSR_SUSTAIN, 50);
+            set_param(PARAM_ADSR_RELEASE, 50);
+
+
+            //Biquad settings
+            set_param(PARAM_FILTER_STATUS, 1);
+            set_param(PARAM_FILTER_TYPE, filterType::BANDPASS);
+            set_param(PARAM_FILTER_Q, 0.01);
+            //filter_->setPeakGain(100);
+
+            //lfo settings
+            set_param(PARAM_LFO_TYPE, 0);
+            set_param(PARAM_LFO_FREQ, 2);
+
+            //gain (distortion) settings
+            set_param(PARAM_DISTORTION_DRIVE, 2.0);
+            set_param(PARAM_DISTORTION_MODEL, DISTORTION_ATAN);
+            set_param(PARAM_DISTORTION_OVERSAMPLING, 2);
+
+
+        break;
+
+
+        case nice_pulse:
+
+            //oscillator settings
+            set_param(PARAM_SINE_AMPL, 1);
+            set_param(PARAM_SQUARE_AMPL, 1);
+            set_param(PARAM_SAW_AMPL, 1);
+            set_param(PARAM_NOISE_AMPL, 0);
+
+            //ADSR Settings
+            set_param(PARAM_ADSR_STATUS, 1);
+            set_param(PARAM_ADSR_ATTACK, 30);
+            set_param(PARAM_ADSR_DECAY, 30);
+            set_param(PARAM_ADSR_SUSTAIN, 50);
+            set_param(PARAM_ADSR_RELEASE, 50);
+
+
+            //Biquad settings
+            set_param(PARAM_FILTER_STATUS, 1);
+            set_param(PARAM_FILTER_TYPE, filterType::HIGHSHELF);
+            //filter_->setQ(0.01);
+            set_param(PARAM_FILTER_GAIN, 15);
+
+            //lfo settings
+            set_param(PARAM_LFO_TYPE, 2);
+            set_param(PARAM_LFO_FREQ, 5);
+
+            //gain (distortion) settings
+            set_param(PARAM_DISTORTION_DRIVE, 5.0);
+            set_param(PARAM_DISTORTION_MODEL, DISTORTION_ATAN);
+            set_param(PARAM_DISTORTION_OVERSAMPLING, 2);
+
+
+        break;
+
+
+        case in_the_night:
+
+            //oscillator settings
+            set_param(PARAM_SINE_AMPL, 0);
+            set_param(PARAM_SQUARE_AMPL, 1);
+            set_param(PARAM_SAW_AMPL, 1);
+            set_param(PARAM_NOISE_AMPL, 0);
+
+            //ADSR Settings
+            set_param(PARAM_ADSR_STATUS, 1);
+            set_param(PARAM_ADSR_ATTACK, 3);
+            set_param(PARAM_ADSR_DECAY, 15);
+            set_param(PARAM_ADSR_SUSTAIN, 70);
+            set_param(PARAM_ADSR_RELEASE, 30);
+
+
+            //Biquad settings
+            set_param(PARAM_FILTER_STATUS, 1);
+            set_param(PARAM_FILTER_TYPE, filterType::LOWPASS);
+            set_param(PARAM_FILTER_Q, 0.5);
+            //filter_->setPeakGain(15);
+
+            //lfo settings
+            set_param(PARAM_LFO_TYPE, 1);
+            set_param(PARAM_LFO_FREQ, 3);
+
+            //gain (distortion) settings
+            set_param(PARAM_DISTORTION_DRIVE, 5.0);
+            set_param(PARAM_DISTORTION_MODEL, DISTORTION_ATAN);
+            set_param(PARAM_DISTORTION_OVERSAMPLING, 2);
+
+
+        break;
+
+
+        case high_hat:
+
+            //oscillator settings
+            set_param(PARAM_SINE_AMPL, 1);
+            set_param(PARAM_SQUARE_AMPL, 1);
+            set_param(PARAM_SAW_AMPL, 1);
+            set_param(PARAM_NOISE_AMPL, 1);
+
+            //ADSR Settings
+            set_param(PARAM_ADSR_STATUS, 0);
+            /*SetAllADSRAttackTime(3);
+            SetAllADSRDecayTime(15);
+            SetAllADSRSustainLevel(70);
+            SetAllADSRReleaseTime(30);*/
+
+
+            //Biquad settings
+            set_param(PARAM_FILTER_STATUS, 1);
+            set_param(PARAM_FILTER_TYPE, filterType::HIGHPASS);
+            set_param(PARAM_FILTER_Q, 0.09);
+            //filter_->setPeakGain(15);
+
+            //lfo settings
+            set_param(PARAM_LFO_TYPE, 1);
+            set_param(PARAM_LFO_FREQ, 8);
+
+            //gain (distortion) settings
+            set_param(PARAM_DISTORTION_DRIVE, 3.0);
+            set_param(PARAM_DISTORTION_MODEL, DISTORTION_ATAN);
+            set_param(PARAM_DISTORTION_OVERSAMPLING, 2);
+
+
+        break;
+
+    }
+}
@@ -0,0 +1,158 @@
+/**
+ * @file voiceallocator.cpp
+ * @brief VoiceAllocator class implementation.
+ */
+
+#include "voiceallocator.h"
+
+VoiceAllocator::VoiceAllocator(VoiceBank *bank)
+{
+    bank_ = bank;
+
+    auto size = bank_->GetSize();
+    prev_.assign(size, -1);
+    next_.assign(size, -1);
+    list_.assign(size, LIST_FREE);
+    note_.assign(size, -1);
+
+    for (int l = 0; l < 3; l++)
+    {
+        head_[l] = tail_[l] = -1;
+        count_[l] = 0;
+    }
+    for (size_t n = 0; n < kNotes; n++)
+        note_to_voice_[n] = -1;
+
+    // the lowest voice is used first
+    for (size_t v = 0; v < size; v++)
+        append((int)v, LIST_FREE);
+}
+
+VoiceAllocator::~VoiceAllocator()
+{
+}
+
+int
+VoiceAllocator::NoteOn(int note)
+{
+    if (note < 0 || note >= (int)kNotes)
+        return -1;
+
+    // a held note is retriggered on its own voice
+    auto voice = (int)note_to_voice_[note];
+    if (voice < 0)
+        voice = steal();
+
+    // the stolen voice loses its former note
+    if (note_[voice] >= 0)
+        note_to_voice_[note_[voice]] = -1;
+
+    unlink(voice);
+    append(voice, LIST_ACTIVE);
+    note_[voice] = note;
+    note_to_voice_[note] = (int16_t)voice;
+
+    return voice;
+}
+
+int
+VoiceAllocator::NoteOff(int note)
+{
+    auto voice = GetVoice(note);
+    if (voice < 0)
+        return -1;
+
+    unlink(voice);
+    append(voice, LIST_RELEASING);
+    note_[voice] = -1;
+    note_to_voice_[note] = -1;
+
+    return voice;
+}
+
+void
+VoiceAllocator::Reclaim()
+{
+    auto voice = head_[LIST_RELEASING];
+    while (voice >= 0)
+    {
+        auto next = next_[voice];
+        if (bank_->IsIdle(voice))
+        {
+            unlink(voice);
+            append(voice, LIST_FREE);
+        }
+        voice = next;
+    }
+}
+
+int
+VoiceAllocator::GetVoice(int note)
+{
+    if (note < 0 || note >= (int)kNotes)
+        return -1;
+
+    return note_to_voice_[note];
+}
+
+int
+VoiceAllocator::steal()
+{
+    if (head_[LIST_FREE] >= 0)
+        return head_[LIST_FREE];
+
+    // the quietest of the oldest releasing voices
+    auto voice = head_[LIST_RELEASING];
+    if (voice >= 0)
+    {
+        auto best = voice;
+        auto best_level = bank_->GetLevel(voice);
+        for (size_t i = 1; i < kStealCandidates && next_[voice] >= 0; i++)
+        {
+            voice = next_[voice];
+            auto level = bank_->GetLevel(voice);
+            if (level < best_level)
+            {
+                best = voice;
+                best_level = level;
+            }
+        }
+        return best;
+    }
+
+    return head_[LIST_ACTIVE];
+}
+
+void
+VoiceAllocator::unlink(int voice)
+{
+    auto list = list_[voice];
+
+    if (prev_[voice] >= 0)
+        next_[prev_[voice]] = next_[voice];
+    else
+        head_[list] = next_[voice];
+
+    if (next_[voice] >= 0)
+        prev_[next_[voice]] = prev_[voice];
+    else
+        tail_[list] = prev_[voice];
+
+    prev_[voice] = next_[voice] = -1;
+    count_[list]--;
+}
+
+void
+VoiceAllocator::append(int voice, int list)
+{
+    prev_[voice] = tail_[list];
+    next_[voice] = -1;
+    if (tail_[list] >= 0)
+        next_[tail_[list]] = voice;
+    else
+        head_[list] = voice;
+    tail_[list] = voice;
+
+    list_[voice] = list;
+    count_[list]++;
+}
@@ -0,0 +1,350 @@
+/**
+ * @file voicebank.cpp
+ * @brief VoiceBank class implementation.
+ */
+
+#include "voicebank.h"
+
+#include <math.h>
+
+#include "polyblep.h"
+#include "sinekernel.h"
+
+VoiceBank::VoiceBank(uint32_t fs, size_t size)
+{
+    size_ = size;
+    fs_ = fs;
+
+    phase_.assign(size_, 0.0);
+    increment_.assign(size_, 2.0 * M_PI * 440.0 / fs_);
+    ampl_.assign(size_, 0.0);
+    envelope_.resize(size_);
+    for (auto &env : envelope_)
+        env.SetSampleRate(fs_);
+    rel_note_.resize(size_);
+    noise_.resize(size_);
+    SetNoiseSeed(1);
+    active_pos_.assign(size_, -1);
+    active_.assign(size_, -1);
+    active_count_ = 0;
+
+    sine_ampl_ = 0.0;
+    saw_ampl_ = 0.0;
+    square_ampl_ = 0.0;
+    noise_ampl_ = 0.0;
+    wave_ampl_ = 0.0;
+    adsr_status_ = false;
+    wavetable_status_ = false;
+    polyblep_status_ = false;
+    mix_dirty_ = true;
+
+    // the built-in tables are built on first use, which takes milliseconds, so that happens
+    // here and not in the render thread when the wavetable mode is switched on
+    sine_table_ = &Wavetable::GetShape(SHAPE_SINE);
+    saw_table_ = &Wavetable::GetShape(SHAPE_SAW);
+    square_table_ = &Wavetable::GetShape(SHAPE_SQUARE);
+}
+
+VoiceBank::~VoiceBank()
+{
+}
+
+void
+VoiceBank::NoteOn(size_t voice, double f, double a, double offset)
+{
+    increment_[voice] = 2.0 * M_PI * f * (1.0 / fs_);
+    phase_[voice] = offset * increment_[voice];
+    ampl_[voice] = a;
+
+    rel_note_[voice].gate(releaseNote::note_on);
+    envelope_[voice].SetState(noteState::ATTACK);
+
+    activate(voice);
+}
+
+void
+VoiceBank::NoteOff(size_t voice)
+{
+    rel_note_[voice].gate(releaseNote::note_release);
+    envelope_[voice].SetState(noteState::RELEASE);
+}
+
+bool
+VoiceBank::IsIdle(size_t voice)
+{
+    if (adsr_status_)
+        return envelope_[voice].GetState() == noteState::NOTE_OFF;
+    return rel_note_[voice].getState() == releaseNote::note_off;
+}
+
+float
+VoiceBank::GetLevel(size_t voice)
+{
+    auto env = adsr_status_ ? envelope_[voice].GetOutput() : rel_note_[voice].getOutput();
+    return (float)(env * ampl_[voice]);
+}
+
+void
+VoiceBank::RenderBlock(float *out, size_t n)
+{
+    UpdateWavetable();
+    RenderActive(0, active_count_, out, n, scratch_);
+    RetireIdle();
+}
+
+void
+VoiceBank::RenderActive(size_t first, size_t last, float *out, size_t n, voiceScratch &scratch)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = 0.0f;
+
+    if (first >= last)
+        return;
+
+    // the scratch buffers are fixed size, so the block is split into chunks
+    for (size_t done = 0; done < n; done += voiceScratch::kChunkSize)
+    {
+        auto m = n - done;
+        if (m > voiceScratch::kChunkSize)
+            m = voiceScratch::kChunkSize;
+
+        for (size_t i = first; i < last; i++)
+            render_voice(active_[i], out + done, m, scratch);
+    }
+}
+
+void
+VoiceBank::RetireIdle()
+{
+    // voices whose envelope has finished leave the set, backwards so the swap skips nothing
+    for (size_t i = active_count_; i-- > 0;)
+    {
+        if (IsIdle(active_[i]))
+            deactivate(active_[i]);
+    }
+}
+
+void
+VoiceBank::activate(size_t v)
+{
+    if (active_pos_[v] >= 0)
+        return;
+
+    active_[active_count_] = (int)v;
+    active_pos_[v] = (int)active_count_;
+    active_count_++;
+}
+
+void
+VoiceBank::deactivate(size_t v)
+{
+    auto pos = active_pos_[v];
+    if (pos < 0)
+        return;
+
+    auto last = active_[--active_count_];
+    active_[pos] = last;
+    active_pos_[last] = pos;
+    active_pos_[v] = -1;
+}
+
+void
+VoiceBank::render_voice(size_t v, float *out, size_t n, voiceScratch &s)
+{
+    auto inc = increment_[v];
+    auto periodic = sine_ampl_ != 0.0 || saw_ampl_ != 0.0 || square_ampl_ != 0.0
+                    || (wavetable_status_ && wave_ampl_ != 0.0);
+
+    if (periodic)
+    {
+        // phase of every sample, rotate to next step and wrap to 2 pi
+        auto phi = phase_[v];
+        for (size_t i = 0; i < n; i++)
+        {
+            s.phase[i] = (float)phi;
+            phi += inc;
+            if (phi >= 2.0 * M_PI)
+                phi -= 2.0 * M_PI;
+        }
+        phase_[v] = phi;
+
+        // sine, sawtooth and square share the phase of the voice
+        if (wavetable_status_)
+            mix_table_.Render(s.phase, inc, s.voice, n);
+        else
+            render_naive(inc, n, s);
+    }
+    else
+    {
+        // nothing to render, the phase only moves on
+        phase_[v] = fmod(phase_[v] + n * inc, 2.0 * M_PI);
+        for (size_t i = 0; i < n; i++)
+            s.voice[i] = 0.0f;
+    }
+
+    // random numbers between -1 and 1 from the generator of the voice
+    if (noise_ampl_ != 0.0)
+        NoiseKernel::Mix(noise_[v], s.voice, (float)noise_ampl_, n);
+
+    // if adsr is activated, multiply envelope and signal
+    // the envelope runs on a silent mix as well, so the voice still finishes and leaves the set
+    if (adsr_status_)
+        envelope_[v].ProcessBlock(s.voice, n);
+    else
+        rel_note_[v].processBlock(s.voice, n);
+
+    if (!periodic && noise_ampl_ == 0.0)
+        return;
+
+    auto a = (float)ampl_[v];
+    for (size_t i = 0; i < n; i++)
+        out[i] += s.voice[i] * a;
+}
+
+void
+VoiceBank::render_naive(double inc, size_t n, voiceScratch &s)
+{
+    auto pi = (float)M_PI;
+
+    if (sine_ampl_ != 0.0)
+    {
+        SineKernel::Process(s.phase, s.sine, n);
+        auto sine_ampl = (float)sine_ampl_;
+        for (size_t i = 0; i < n; i++)
+            s.voice[i] = sine_ampl * s.sine[i];
+    }
+    else
+    {
+        for (size_t i = 0; i < n; i++)
+            s.voice[i] = 0.0f;
+    }
+
+    if (saw_ampl_ == 0.0 && square_ampl_ == 0.0)
+        return;
+
+    auto saw_ampl = (float)(saw_ampl_ / M_PI);
+    auto square_ampl = (float)square_ampl_;
+    for (size_t i = 0; i < n; i++)
+    {
+        auto p = s.phase[i];
+        s.voice[i] += saw_ampl * (p - pi)
+                       + square_ampl * ((p <= pi) ? 1.0f : -1.0f);
+    }
+
+    if (!polyblep_status_)
+        return;
+
+    // smooth the jump of the sawtooth at 0 (down) and of the square at 0 (up) and pi (down)
+    auto blep_saw = (float)-saw_ampl_;
+    auto blep_square = (float)square_ampl_;
+    auto dt = (float)(inc / (2.0 * M_PI));
+    auto to_periods = (float)(1.0 / (2.0 * M_PI));
+    for (size_t i = 0; i < n; i++)
+    {
+        auto t = s.phase[i] * to_periods;
+        auto t2 = (t < 0.5f) ? t + 0.5f : t - 0.5f;
+        auto r = polyblep_residual(t, dt);
+        s.voice[i] += (blep_saw + blep_square) * r - blep_square * polyblep_residual(t2, dt);
+    }
+}
+
+void
+VoiceBank::SetSineAmpl(double a)
+{
+    if (a == sine_ampl_)
+        return;
+    sine_ampl_ = a;
+    mix_dirty_ = true;
+}
+
+void
+VoiceBank::SetSawAmpl(double a)
+{
+    if (a == saw_ampl_)
+        return;
+    saw_ampl_ = a;
+    mix_dirty_ = true;
+}
+
+void
+VoiceBank::SetSquareAmpl(double a)
+{
+    if (a == square_ampl_)
+        return;
+    square_ampl_ = a;
+    mix_dirty_ = true;
+}
+
+void
+VoiceBank::SetWaveAmpl(double a)
+{
+    if (a == wave_ampl_)
+        return;
+    wave_ampl_ = a;
+    mix_dirty_ = true;
+}
+
+bool
+VoiceBank::LoadWaveform(const char *path)
+{
+    if (!user_table_.LoadFile(path))
+        return false;
+
+    mix_dirty_ = true;
+    return true;
+}
+
+void
+VoiceBank::UpdateWavetable()
+{
+    if (!wavetable_status_ || !mix_dirty_)
+        return;
+
+    update_wavetable();
+    mix_dirty_ = false;
+}
+
+void
+VoiceBank::update_wavetable()
+{
+    mix_table_.Clear();
+    mix_table_.Add(*sine_table_, sine_ampl_);
+    mix_table_.Add(*saw_table_, saw_ampl_);
+    mix_table_.Add(*square_table_, square_ampl_);
+    mix_table_.Add(user_table_, wave_ampl_);
+}
+
+void
+VoiceBank::SetNoiseSeed(uint32_t seed)
+{
+    for (size_t v = 0; v < size_; v++)
+        NoiseKernel::Seed(noise_[v], seed + (uint32_t)v);
+}
+
+void
+VoiceBank::SetADSRAttack(float t)
+{
+    for (auto &env : envelope_)
+        env.SetAttack(t);
+}
+
+void
+VoiceBank::SetADSRDecay(float t)
+{
+    for (auto &env : envelope_)
+        env.SetDecay(t);
+}
+
+void
+VoiceBank::SetADSRSustain(float level)
+{
+    for (auto &env : envelope_)
+        env.SetSustain(level);
+}
+
+void
+VoiceBank::SetADSRRelease(float t)
+{
+    for (auto &env : envelope_)
+        env.SetRelease(t);
+}
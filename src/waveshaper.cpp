@@ -0,0 +1,30 @@
+/**
+ * @file waveshaper.cpp
+ * @brief Waveshaper class implementation.
+ */
+
+#include "waveshaper.h"
+
+Waveshaper::Waveshaper(shapeFunction shape, float range)
+{
+    auto intervals = kTableSize - 1;
+    scale_ = (float)(intervals / (2.0 * range));
+    offset_ = (float)(intervals / 2.0);
+    // the largest position below the last point, so every position has a right neighbour
+    max_pos_ = (float)intervals * (1.0f - 1e-6f);
+
+    table_.resize(kTableSize);
+    for (size_t i = 0; i < kTableSize; i++)
+        table_[i] = (float)shape(-range + 2.0 * range * i / intervals);
+}
+
+Waveshaper::~Waveshaper()
+{
+}
+
+void
+Waveshaper::ProcessBlock(const float *in, float *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = Process(in[i]);
+}
@@ -0,0 +1,280 @@
+/**
+ * @file wavetable.cpp
+ * @brief Wavetable class implementation.
+ */
+
+#include "wavetable.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <aixlog.hpp>
+
+// phase increment in periods per sample, up to which level 0 is used without crossfade
+static const double kBaseInc = 1.0 / Wavetable::kTableSize;
+
+Wavetable::Wavetable()
+{
+    table_.assign(kLevels * kStride, 0.0f);
+}
+
+Wavetable::Wavetable(int shape)
+{
+    std::vector<double> sin_ampl(kTableSize / 2, 0.0);
+    std::vector<double> cos_ampl(kTableSize / 2, 0.0);
+
+    for (size_t k = 1; k < sin_ampl.size(); k++)
+    {
+        if (shape == SHAPE_SAW)
+            // (phi - pi) / pi
+            sin_ampl[k] = -2.0 / (M_PI * k);
+        else if (shape == SHAPE_SQUARE)
+            // odd harmonics only
+            sin_ampl[k] = (k % 2) ? 4.0 / (M_PI * k) : 0.0;
+    }
+    if (shape != SHAPE_SAW && shape != SHAPE_SQUARE)
+        sin_ampl[1] = 1.0;
+
+    SetHarmonics(sin_ampl, cos_ampl);
+}
+
+Wavetable::~Wavetable()
+{
+}
+
+const Wavetable &
+Wavetable::GetShape(int shape)
+{
+    static const Wavetable sine(SHAPE_SINE);
+    static const Wavetable saw(SHAPE_SAW);
+    static const Wavetable square(SHAPE_SQUARE);
+
+    if (shape == SHAPE_SAW)
+        return saw;
+    else if (shape == SHAPE_SQUARE)
+        return square;
+    return sine;
+}
+
+void
+Wavetable::SetHarmonics(const std::vector<double> &sin_ampl, const std::vector<double> &cos_ampl)
+{
+    table_.assign(kLevels * kStride, 0.0f);
+
+    // one period of cos, sin is read with a quarter period offset
+    std::vector<double> cos_table(kTableSize);
+    for (size_t i = 0; i < kTableSize; i++)
+        cos_table[i] = cos(2.0 * M_PI * i / kTableSize);
+
+    auto harmonics = std::max(sin_ampl.size(), cos_ampl.size());
+    auto dc = cos_ampl.empty() ? 0.0 : cos_ampl[0];
+    std::vector<double> level(kTableSize);
+
+    for (size_t l = 0; l < kLevels; l++)
+    {
+        // highest harmonic, which stays below nyquist up to the top frequency of the level
+        auto top_inc = kBaseInc * (2 << l);
+        auto k_max = (size_t)floor(0.5 / top_inc);
+        if (k_max > kTableSize / 2 - 1)
+            k_max = kTableSize / 2 - 1;
+        if (k_max + 1 > harmonics)
+            k_max = (harmonics > 0) ? harmonics - 1 : 0;
+
+        level.assign(kTableSize, dc);
+        for (size_t k = 1; k <= k_max; k++)
+        {
+            auto a = (k < sin_ampl.size()) ? sin_ampl[k] : 0.0;
+            auto b = (k < cos_ampl.size()) ? cos_ampl[k] : 0.0;
+            if (a == 0.0 && b == 0.0)
+                continue;
+
+            for (size_t i = 0; i < kTableSize; i++)
+            {
+                auto j = (k * i) & (kTableSize - 1);
+                auto s = cos_table[(j + 3 * kTableSize / 4) & (kTableSize - 1)];
+                level[i] += a * s + b * cos_table[j];
+            }
+        }
+
+        auto row = &table_[l * kStride];
+        for (size_t i = 0; i < kTableSize; i++)
+            row[i] = (float)level[i];
+        row[kTableSize] = row[0];
+    }
+}
+
+void
+Wavetable::SetWaveform(const float *cycle, size_t n)
+{
+    if (n < 2)
+        return;
+
+    // fourier series of the period, with a cos table of n points
+    std::vector<double> cos_table(n);
+    for (size_t i = 0; i < n; i++)
+        cos_table[i] = cos(2.0 * M_PI * i / n);
+
+    auto harmonics = std::min(n / 2, kTableSize / 2);
+    std::vector<double> sin_ampl(harmonics, 0.0);
+    std::vector<double> cos_ampl(harmonics, 0.0);
+
+    for (size_t i = 0; i < n; i++)
+        cos_ampl[0] += cycle[i] / n;
+
+    for (size_t k = 1; k < harmonics; k++)
+    {
+        double a = 0.0, b = 0.0;
+        for (size_t i = 0; i < n; i++)
+        {
+            auto j = (k * i) % n;
+            a += cycle[i] * cos_table[(j + 3 * n / 4) % n];
+            b += cycle[i] * cos_table[j];
+        }
+        sin_ampl[k] = 2.0 * a / n;
+        cos_ampl[k] = 2.0 * b / n;
+    }
+
+    SetHarmonics(sin_ampl, cos_ampl);
+}
+
+bool
+Wavetable::LoadFile(const char *path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        LOG(ERROR) << "Wavetable: could not open " << path << "\n";
+        return false;
+    }
+
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    auto u16 = [&](size_t pos) { return (uint32_t)(uint8_t)data[pos] | ((uint32_t)(uint8_t)data[pos + 1] << 8); };
+    auto u32 = [&](size_t pos) { return u16(pos) | (u16(pos + 2) << 16); };
+
+    if (data.size() < 12 || memcmp(&data[0], "RIFF", 4) != 0 || memcmp(&data[8], "WAVE", 4) != 0)
+    {
+        LOG(ERROR) << "Wavetable: " << path << " is not a wav file\n";
+        return false;
+    }
+
+    uint32_t format = 0, channels = 0, bits = 0;
+    size_t pos = 12;
+    while (pos + 8 <= data.size())
+    {
+        auto size = (size_t)u32(pos + 4);
+        auto body = pos + 8;
+        if (body + size > data.size())
+            size = data.size() - body;
+
+        if (memcmp(&data[pos], "fmt ", 4) == 0 && size >= 16)
+        {
+            format = u16(body);
+            channels = u16(body + 2);
+            bits = u16(body + 14);
+        }
+        else if (memcmp(&data[pos], "data", 4) == 0 && channels > 0)
+        {
+            auto frame = channels * bits / 8;
+            std::vector<float> cycle;
+            for (size_t f = body; frame > 0 && f + frame <= body + size; f += frame)
+            {
+                if (format == 1 && bits == 16)
+                    cycle.push_back((int16_t)u16(f) / 32768.0f);
+                else if (format == 3 && bits == 32)
+                {
+                    auto v = u32(f);
+                    float s;
+                    memcpy(&s, &v, sizeof(s));
+                    cycle.push_back(s);
+                }
+                else
+                    break;
+            }
+
+            if (cycle.size() < 2)
+            {
+                LOG(ERROR) << "Wavetable: unsupported sample format in " << path << "\n";
+                return false;
+            }
+
+            SetWaveform(cycle.data(), cycle.size());
+            return true;
+        }
+
+        // chunks are padded to an even size
+        pos = body + size + (size & 1);
+    }
+
+    LOG(ERROR) << "Wavetable: no audio data in " << path << "\n";
+    return false;
+}
+
+void
+Wavetable::Clear()
+{
+    table_.assign(kLevels * kStride, 0.0f);
+}
+
+void
+Wavetable::Add(const Wavetable &table, double a)
+{
+    auto af = (float)a;
+    for (size_t i = 0; i < table_.size(); i++)
+        table_[i] += af * table.table_[i];
+}
+
+void
+Wavetable::select_level(double inc, size_t &level, float &frac) const
+{
+    auto ratio = fabs(inc) / (2.0 * M_PI) / kBaseInc;
+
+    level = 0;
+    frac = 0.0f;
+    if (ratio <= 1.0)
+        return;
+
+    auto lf = log2(ratio);
+    level = (size_t)lf;
+    frac = (float)(lf - level);
+    if (level >= kLevels - 1)
+    {
+        level = kLevels - 1;
+        frac = 0.0f;
+    }
+}
+
+void
+Wavetable::Render(const float *phase, double inc, float *out, size_t n) const
+{
+    size_t level;
+    float frac;
+    select_level(inc, level, frac);
+
+    auto lo = &table_[level * kStride];
+    // the last level crossfades with itself
+    auto hi = (level + 1 < kLevels) ? lo + kStride : lo;
+    auto scale = (float)(kTableSize / (2.0 * M_PI));
+
+    for (size_t i = 0; i < n; i++)
+    {
+        auto idx = phase[i] * scale;
+        auto i0 = (size_t)idx;
+        auto f = idx - i0;
+        i0 &= kTableSize - 1;
+
+        auto a = lo[i0] + f * (lo[i0 + 1] - lo[i0]);
+        auto b = hi[i0] + f * (hi[i0 + 1] - hi[i0]);
+        out[i] = a + frac * (b - a);
+    }
+}
+
+float
+Wavetable::GetSample(double phase, double inc) const
+{
+    float p = (float)phase;
+    float out;
+    Render(&p, inc, &out, 1);
+    return out;
+}
@@ -0,0 +1,100 @@
+//class WavetableOsc
+//
+// band-limited oscillator, which reads its signal from a mipmapped Wavetable
+
+#include "wavetableosc.h"
+
+WavetableOsc::WavetableOsc(const Wavetable *tab, double f, double a, double p,  int fS) {
+    wt      = tab;
+    freq    = f;
+    amp     = a;
+    phi     = p;
+    fs      = fS;
+    curr_ampl = 0.0;
+}
+
+double WavetableOsc::getNextSample() {
+
+    /// This method gets the next sample of the wavetable.
+    /// The amplitude is applied and the angle of the
+    /// oscillator is increased, according to the sample rate.
+
+    double inc = 2.0*M_PI * freq * (1.0/fs);
+
+    double thisVal = wt->GetSample(phi, inc) * amp;
+
+    // rotate to next step and wrap to 2 pi, keeping the fractional phase
+    phi += inc;
+    if(phi>=2*M_PI)
+        phi-=2*M_PI;
+
+    curr_ampl = thisVal;
+
+    return thisVal;
+
+}
+
+void WavetableOsc::renderBlock(float *out, size_t n) {
+
+    /// This method renders the next n samples of the wavetable.
+    /// The phases of the block are written to out first, the
+    /// table read then overwrites them in place.
+
+    double p = phi;
+    double inc = 2.0*M_PI * freq * (1.0/fs);
+
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (float)p;
+
+        p += inc;
+        if(p>=2*M_PI)
+            p-=2*M_PI;
+    }
+
+    wt->Render(out, inc, out, n);
+
+    float a = (float)amp;
+    for (size_t i = 0; i < n; i++)
+        out[i] *= a;
+
+    phi = p;
+    if (n > 0)
+        curr_ampl = out[n-1];
+}
+
+// getter methods
+double WavetableOsc::frequency() {
+    return freq;
+}
+
+// method returns the non time-dependand (peak) amplitude
+double WavetableOsc::amplitude() {
+    return amp;
+}
+
+double WavetableOsc::phase() {
+    return phi;
+}
+
+// method returns the current time-dependend amplitude of the oscillating signal 
+double WavetableOsc::getCurrentAmpl() {
+
+    return curr_ampl;
+}
+
+//setter methods
+void WavetableOsc::frequency(double f) {
+    freq = f;
+}
+
+void WavetableOsc::amplitude(double a) {
+    amp = a;
+}
+
+void WavetableOsc::phase(double p) {
+    phi = p;
+}
+
+void WavetableOsc::table(const Wavetable *tab) {
+    wt = tab;
+}